@@ -0,0 +1,222 @@
+#include "Graph.h"
+
+#include <immintrin.h>
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+namespace {
+    // triangles (u, v, w) with u the lowest-ranked vertex: w in both oriented lists of u and v, one count for each
+    // of the three edges, indexed by their oriented position
+    void CountTrianglesScalar(const vector<int> &edges, vector<int> &triangle_num, ui i, ui offset_u, ui end_u,
+                              ui offset_v, ui end_v) {
+        auto local_num = 0;
+        while (offset_u < end_u && offset_v < end_v) {
+            if (edges[offset_u] < edges[offset_v]) {
+                ++offset_u;
+            } else if (edges[offset_u] > edges[offset_v]) {
+                ++offset_v;
+            } else {
+                __sync_fetch_and_add(&triangle_num[offset_u++], 1);
+                __sync_fetch_and_add(&triangle_num[offset_v++], 1);
+                ++local_num;
+            }
+        }
+        if (local_num > 0) { __sync_fetch_and_add(&triangle_num[i], local_num); }
+    }
+
+    void CountTriangles(const vector<ui> &start, const vector<int> &edges, vector<int> &triangle_num, int u, ui i) {
+        auto v = edges[i];
+        auto offset_u = start[u], end_u = start[u + 1];     // w ranks above v by its place in the list of v
+        auto offset_v = start[v], end_v = start[v + 1];
+#if defined(ENABLE_AVX2)
+        constexpr ui parallelism = 8;
+        // 8x8 blocks in 8 lane rotations, lane i of u matching lane i + r of v; the k-th matched lanes of both
+        // blocks are the same element since the lists are sorted
+        auto rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+        auto local_num = 0;
+        while (offset_u + parallelism <= end_u && offset_v + parallelism <= end_v) {
+            auto ids_u = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&edges[offset_u]));
+            auto ids_v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&edges[offset_v]));
+            ui mask_u = 0, mask_v = 0;
+            for (auto r = 0u; r < parallelism; r++) {
+                auto mask = static_cast<ui>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(ids_u, ids_v))));
+                mask_u |= mask;
+                mask_v |= ((mask << r) | (mask >> (parallelism - r))) & 0xffu;
+                ids_v = _mm256_permutevar8x32_epi32(ids_v, rotate);
+            }
+            while (mask_u != 0) {
+                __sync_fetch_and_add(&triangle_num[offset_u + __builtin_ctz(mask_u)], 1);
+                __sync_fetch_and_add(&triangle_num[offset_v + __builtin_ctz(mask_v)], 1);
+                mask_u &= mask_u - 1;
+                mask_v &= mask_v - 1;
+                ++local_num;
+            }
+            auto last_u = edges[offset_u + parallelism - 1], last_v = edges[offset_v + parallelism - 1];
+            if (last_u <= last_v) { offset_u += parallelism; }
+            if (last_v <= last_u) { offset_v += parallelism; }
+        }
+        if (local_num > 0) { __sync_fetch_and_add(&triangle_num[i], local_num); }
+#endif
+        CountTrianglesScalar(edges, triangle_num, i, offset_u, end_u, offset_v, end_v);
+    }
+}
+
+void Graph::SetSimilarityEngine(SimilarityEngine engine) {
+    similarity_engine = engine;
+}
+
+void Graph::SetSimilarityExport(bool is_export_similarity) {
+    this->is_export_similarity = is_export_similarity;
+}
+
+SimilarityEngine Graph::ChooseSimilarityEngine() {
+    auto start = high_resolution_clock::now();
+    // the edges of every ENGINE_SAMPLE_STRIDE-th vertex
+    auto sample_num = (n + ENGINE_SAMPLE_STRIDE - 1) / ENGINE_SAMPLE_STRIDE;
+    auto sampled_num = ParallelReduce(profile.schedule.thread_num, sample_num, 0l, [this](ui i_start, ui i_end) {
+        auto local_num = 0l;
+        for (auto i = i_start; i < i_end; i++) { local_num += Degree(i * ENGINE_SAMPLE_STRIDE) - 1; }
+        return local_num;
+    });
+    // check-core stops at the first crossed threshold: expected visits of the undecided edges, from the similar
+    // fraction of a few of them computed exactly
+    auto visit_num = ParallelReduce(profile.schedule.thread_num, sample_num, 0.0, [this](ui i_start, ui i_end) {
+        auto local_num = 0.0;
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = static_cast<int>(i * ENGINE_SAMPLE_STRIDE);
+            auto sd = 0, ed = Degree(u) - 1, undecided_num = 0, computed_num = 0, similar_num = 0;
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto state = PruneState(u, edge_idx);
+                if (state == SIMILAR) {
+                    sd++;
+                } else if (state == NOT_SIMILAR) {
+                    ed--;
+                } else {
+                    undecided_num++;
+                    if (computed_num < ENGINE_SAMPLE_EDGES) {
+                        computed_num++;
+                        auto v = out_edges[edge_idx];
+                        if (IntersectSelectedKernel(u, v, state) == SIMILAR) { similar_num++; }
+                    }
+                }
+            }
+            if (sd >= min_u || ed < min_u) { continue; }
+            auto p = (similar_num + 0.5) / (computed_num + 1);
+            local_num += min(static_cast<double>(undecided_num), min((min_u - sd) / p, (ed - min_u + 1) / (1 - p)));
+        }
+        return local_num;
+    });
+    auto ratio = sampled_num > 0 ? visit_num / sampled_num : 0.0;
+    auto engine = ratio >= ALL_EDGE_VISIT_RATIO ? SimilarityEngine::ALL_EDGE : SimilarityEngine::PIPELINE;
+    auto end = high_resolution_clock::now();
+    cout << "engine chooser, sampled edges:" << sampled_num << ", expected check-core visits:" << ratio
+         << ", engine:" << SimilarityEngineName(engine) << ", time:"
+         << duration_cast<microseconds>(end - start).count() / 1000.0 << " ms\n";
+    return engine;
+}
+
+void Graph::AllEdgeSimilarity() {
+    auto start = high_resolution_clock::now();
+    AllocateStandardLayout();
+    auto thread_num = profile.schedule.thread_num;
+
+    // degree-ordered orientation: u -> v iff v ranks higher by (degree, id), the lists keep the id order
+    auto is_oriented = [this](int u, int v) { return Degree(u) < Degree(v) || (Degree(u) == Degree(v) && u < v); };
+    vector<ui> oriented_start(n + 1, 0);
+    ParallelForStatic(thread_num, n, [this, &oriented_start, &is_oriented](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (is_oriented(u, out_edges[edge_idx])) { ++oriented_start[u]; }
+            }
+        }
+    });
+    ParallelExclusiveScan(thread_num, oriented_start);
+    vector<int> oriented_edges(oriented_start[n]);
+    vector<ui> edge_ids(oriented_start[n]);     // position of the edge in the adjacency of its source
+    ParallelForStatic(thread_num, n, [&, this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            auto pos = oriented_start[u];
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (is_oriented(u, out_edges[edge_idx])) {
+                    oriented_edges[pos] = out_edges[edge_idx];
+                    edge_ids[pos++] = edge_idx;
+                }
+            }
+        }
+    });
+    auto orient_end = high_resolution_clock::now();
+
+    // triangle counting, each triangle once
+    vector<int> triangle_num(oriented_start[n], 0);
+    ExecuteLongestFirst("all-edge: triangle counting", profile.schedule, n, [&oriented_start](ui u) -> long {
+        auto out_degree = static_cast<long>(oriented_start[u + 1] - oriented_start[u]);
+        return out_degree * out_degree + 1;
+    }, [&](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto i = oriented_start[u]; i < oriented_start[u + 1]; i++) {
+                CountTriangles(oriented_start, oriented_edges, triangle_num, u, i);
+            }
+        }
+    });
+    auto count_end = high_resolution_clock::now();
+
+    // exact states of both directions, cn counting u and v themselves
+    if (is_export_similarity) { edge_common_num.assign(out_edges.size(), 0); }
+    auto triangle_total = ParallelReduce(thread_num, n, 0l, [&, this](ui i_start, ui i_end) {
+        auto local_total = 0l;
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto i = oriented_start[u]; i < oriented_start[u + 1]; i++) {
+                auto v = oriented_edges[i];
+                auto cn = triangle_num[i] + 2;
+                auto state = cn >= similarity.MinCn(Degree(u), Degree(v)) ? SIMILAR : NOT_SIMILAR;
+                auto reverse_edge_idx = BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u);
+                min_cn[edge_ids[i]] = state;
+                min_cn[reverse_edge_idx] = state;
+                if (is_export_similarity) {
+                    edge_common_num[edge_ids[i]] = cn;
+                    edge_common_num[reverse_edge_idx] = cn;
+                }
+                local_total += triangle_num[i];
+            }
+        }
+        return local_total;
+    });
+    ParallelForStatic(thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            auto sd = 0;
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (min_cn[edge_idx] == SIMILAR) { ++sd; }
+            }
+            similar_degree[u] = sd;
+            effective_degree[u] = sd;
+            core_status_lst[u] = sd >= min_u ? CORE : NON_CORE;
+        }
+    });
+
+    auto end = high_resolution_clock::now();
+    cout << "all-edge: orientation time:" << duration_cast<milliseconds>(orient_end - start).count()
+         << " ms, triangle counting time:" << duration_cast<milliseconds>(count_end - orient_end).count()
+         << " ms, triangles:" << triangle_total / 3 << ", states time:"
+         << duration_cast<milliseconds>(end - count_end).count() << " ms\n";
+}
+
+void Graph::OutputSimilarities(const char *eps_s, const char *miu) {
+    if (edge_common_num.empty()) {
+        cout << "no similarities to export, the all-edge engine keeps them\n";
+        return;
+    }
+    vector<float> similarities(out_edges.size());
+    ParallelForStatic(profile.schedule.thread_num, n, [this, &similarities](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                similarities[edge_idx] = static_cast<float>(
+                        Similarity::Value(edge_common_num[edge_idx], Degree(u), Degree(out_edges[edge_idx])));
+            }
+        }
+    });
+    io_helper_ptr->OutputSimilarities(eps_s, miu, similarities);
+}
@@ -0,0 +1,42 @@
+#ifndef PPSCAN_ALL_EDGE_SIMILARITY_H
+#define PPSCAN_ALL_EDGE_SIMILARITY_H
+
+#include <cstring>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * similarity engines of the standard layout: the pruning pipeline (prune, check-core with early termination), or
+ * all edges exactly (SCAN_XP): the common neighbors of every edge from one pass of triangle counting on the
+ * degree-ordered orientation, each triangle found once by its lowest-ranked vertex; auto picks by the share of the
+ * sampled edges check-core is expected to visit, as the pruning leaves them undecided and early termination skips
+ * the rest
+ */
+enum class SimilarityEngine {
+    PIPELINE, ALL_EDGE, AUTO
+};
+
+constexpr ui ENGINE_SAMPLE_STRIDE = 64;         // every 64th vertex's edges for the estimate
+constexpr int ENGINE_SAMPLE_EDGES = 16;         // undecided edges per sampled vertex computed for the similar share
+constexpr double ALL_EDGE_VISIT_RATIO = 0.5;    // the pipeline gains little once this many edges are visited
+
+inline const char *SimilarityEngineName(SimilarityEngine engine) {
+    switch (engine) {
+        case SimilarityEngine::ALL_EDGE:
+            return "all-edge";
+        case SimilarityEngine::AUTO:
+            return "auto";
+        default:
+            return "pipeline";
+    }
+}
+
+inline SimilarityEngine ParseSimilarityEngine(const char *name) {
+    for (auto engine: {SimilarityEngine::ALL_EDGE, SimilarityEngine::AUTO}) {
+        if (strcmp(name, SimilarityEngineName(engine)) == 0) { return engine; }
+    }
+    return SimilarityEngine::PIPELINE;
+}
+
+#endif //PPSCAN_ALL_EDGE_SIMILARITY_H
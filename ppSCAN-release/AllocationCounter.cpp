@@ -0,0 +1,71 @@
+#include "AllocationCounter.h"
+
+#if defined(COUNT_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+
+static thread_local long thread_allocation_count = 0;
+
+long ThreadAllocationCount() {
+    return thread_allocation_count;
+}
+
+static void *CountedAllocate(std::size_t size) {
+    ++thread_allocation_count;
+    if (size == 0) { size = 1; }
+    for (;;) {
+        auto ptr = std::malloc(size);
+        if (ptr != nullptr) { return ptr; }
+        auto handler = std::get_new_handler();
+        if (handler == nullptr) { throw std::bad_alloc(); }
+        handler();
+    }
+}
+
+void *operator new(std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return CountedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return CountedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+#else
+
+long ThreadAllocationCount() {
+    return 0;
+}
+
+#endif
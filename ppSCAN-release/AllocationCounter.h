@@ -0,0 +1,11 @@
+#ifndef PPSCAN_ALLOCATION_COUNTER_H
+#define PPSCAN_ALLOCATION_COUNTER_H
+
+/*
+ * with COUNT_ALLOCATIONS, operator new/new[] are replaced in AllocationCounter.cpp to count the calls per thread
+ * (malloc/free underneath), the difference of two reads on one thread is the number of heap allocations in between;
+ * otherwise the count stays 0 and the allocator is untouched
+ */
+long ThreadAllocationCount();
+
+#endif //PPSCAN_ALLOCATION_COUNTER_H
@@ -0,0 +1,164 @@
+#include "Graph.h"
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+void Graph::SetAnytimeBlockSizes(ui alpha_block_size, ui beta_block_size) {
+    this->alpha_block_size = max(alpha_block_size, 1u);
+    this->beta_block_size = max(beta_block_size, 1u);
+}
+
+void Graph::AnytimeLink(int u) {
+    if (!IsDefiniteCoreVertex(u)) { return; }
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (min_cn[edge_idx] == SIMILAR && IsDefiniteCoreVertex(v) &&
+            !disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u), static_cast<uint32_t>(v))) {
+            disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+        }
+    }
+}
+
+bool Graph::PublishAnytimeProgress(const char *stage, ui block, ui block_num, bool is_exact, double elapsed_ms,
+                                   double budget_ms, const AnytimeCallback &callback) {
+    auto thread_num = profile.schedule.thread_num;
+    // decided in the high half, cores in the low half, both below 2^32
+    auto packed = ParallelReduce(thread_num, n, 0ul, [this](ui i_start, ui i_end) {
+        auto local_packed = 0ul;
+        for (auto u = i_start; u < i_end; u++) {
+            if (core_status_lst[u] != UN_KNOWN) { local_packed += 1ul << 32; }
+            if (IsDefiniteCoreVertex(u)) { ++local_packed; }
+        }
+        return local_packed;
+    });
+    auto core_cluster_num = ParallelReduce(thread_num, n, 0u, [this](ui i_start, ui i_end) {
+        auto local_num = 0u;
+        for (auto u = i_start; u < i_end; u++) {
+            if (IsDefiniteCoreVertex(u) && disjoint_set_ptr->FindRoot(u) == u) { ++local_num; }
+        }
+        return local_num;
+    });
+    AnytimeProgress progress{stage, block, block_num, elapsed_ms, static_cast<ui>(packed >> 32),
+                             static_cast<ui>(packed & 0xffffffffu), core_cluster_num, is_exact};
+    cout << "anytime, stage:" << stage << ", block:" << block << "/" << block_num << ", elapsed:" << elapsed_ms
+         << " ms, decided vertices:" << progress.decided_num << "/" << n << ", cores:" << progress.core_num
+         << ", core clusters:" << core_cluster_num << (is_exact ? ", exact" : "") << "\n";
+
+    auto is_continue = !callback || callback(progress);
+    return is_exact || (is_continue && (budget_ms <= 0 || elapsed_ms < budget_ms));
+}
+
+void Graph::MaterializeApproximation() {
+    // the known cores with their current sets, non-cores (and undecided vertices) attached by known-similar edges
+    cores.clear();
+    ParallelSelect(profile.schedule.thread_num, n, [this](ui u) { return IsDefiniteCoreVertex(u); }, cores);
+    MarkClusterMinEleAsId();
+    noncore_cluster = std::vector<pair<int, int>>();
+    CollectNonCoreClusters("anytime: approximate non-core", NonCorePairBound(), [this](ui i) -> long {
+        return Degree(cores[i]);
+    }, [this](ui i, NonCoreWriter &writer) {
+        auto u = cores[i];
+        auto cluster_id = cluster_dict[disjoint_set_ptr->FindRoot(static_cast<uint32_t>(u))];
+        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+            auto v = out_edges[edge_idx];
+            if (!IsDefiniteCoreVertex(v) && min_cn[edge_idx] == SIMILAR) {
+                writer.push(make_pair(cluster_id, v));
+            }
+        }
+    });
+}
+
+void Graph::pSCANAnytime(double budget_ms, const AnytimeCallback &callback) {
+    cout << "anytime ppSCAN, runtime:" << RuntimeName() << ", threads:" << profile.schedule.thread_num
+         << ", alpha block:" << alpha_block_size << ", beta block:" << beta_block_size << ", budget:" << budget_ms
+         << " ms, similarity:" << Similarity::NAME << endl;
+    auto start = high_resolution_clock::now();
+    auto elapsed_ms = [&start]() { return duration<double, milli>(high_resolution_clock::now() - start).count(); };
+    auto thread_num = profile.schedule.thread_num;
+    // per-block busy time reports would flood the log
+    auto block_schedule = profile.schedule;
+    block_schedule.is_report = false;
+
+    pSCANFirstPhasePrune();
+    auto undecided_after_prune = CountUndecidedEdges();
+    auto is_stopped = !PublishAnytimeProgress("prune", 1, 1, false, elapsed_ms(), budget_ms, callback);
+
+    // check-core in alpha blocks of the vertices left undecided by the pruning, hubs first; a block's vertices
+    // are decided at its end, its cores linked along their known-similar edges to the cores known so far
+    vector<int> pending;
+    if (!is_stopped) {
+        if (is_owner_computes) {
+            mirror_partitions_ptr = yche::make_unique<MirrorPartitions>(n, out_edge_start,
+                                                                       static_cast<ui>(thread_num));
+        }
+        ProcessHubs(HubPhase::CHECK_CORE_FIRST_BSP);
+        ApplyMirrorUpdates("anytime: apply hub mirror updates");
+        ProcessHubs(HubPhase::CHECK_CORE_SECOND_BSP);
+        ApplyMirrorUpdates("anytime: apply hub mirror updates");
+        ParallelSelect(thread_num, n, [this](ui u) { return core_status_lst[u] == UN_KNOWN; }, pending);
+    }
+    auto pending_num = static_cast<ui>(pending.size());
+    auto alpha_size = AnytimeBlockSize(alpha_block_size, pending_num);
+    auto alpha_block_num = (pending_num + alpha_size - 1) / alpha_size;
+    for (auto b = 0u; b < alpha_block_num && !is_stopped; b++) {
+        auto block = pending.data() + b * alpha_size;
+        auto block_size = min(alpha_size, pending_num - b * alpha_size);
+        for (auto is_first_bsp: {true, false}) {
+            ExecuteLongestFirst("anytime: check core block", block_schedule, block_size,
+                                [this, block, is_first_bsp](ui i) -> long {
+                                    return EstimateCheckCoreCost(block[i], is_first_bsp);
+                                }, [this, block, is_first_bsp](ui i_start, ui i_end) {
+                        auto mirror_writer = NewMirrorWriter();
+                        for (auto i = i_start; i < i_end; i++) {
+                            if (is_first_bsp) {
+                                CheckCoreFirstBSP(block[i], mirror_writer.get());
+                            } else {
+                                CheckCoreSecondBSP(block[i], mirror_writer.get());
+                            }
+                        }
+                    });
+            ApplyMirrorUpdates("anytime: apply mirror updates");
+        }
+        ParallelForStatic(thread_num, block_size, [this, block](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) { AnytimeLink(block[i]); }
+        });
+        is_stopped = !PublishAnytimeProgress("check-core", b + 1, alpha_block_num, false, elapsed_ms(), budget_ms,
+                                             callback);
+    }
+    mirror_partitions_ptr.reset();
+
+    // core clustering: the known-similar edges of every core, then the remaining pairs in beta blocks of cores
+    if (!is_stopped) {
+        ParallelSelect(thread_num, n, [this](ui u) { return IsDefiniteCoreVertex(u); }, cores);
+        ParallelForStatic(thread_num, static_cast<ui>(cores.size()), [this](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) { ClusterCoreFirstPhase(cores[i]); }
+        });
+        ProcessHubs(HubPhase::CLUSTER_CORE);
+    }
+    auto core_num = static_cast<ui>(cores.size());
+    auto beta_size = AnytimeBlockSize(beta_block_size, core_num);
+    auto beta_block_num = (core_num + beta_size - 1) / beta_size;
+    for (auto b = 0u; b < beta_block_num && !is_stopped; b++) {
+        auto block = cores.data() + b * beta_size;
+        auto block_size = min(beta_size, core_num - b * beta_size);
+        ExecuteLongestFirst("anytime: cluster core block", block_schedule, block_size, [this, block](ui i) -> long {
+            return EstimateClusterCost(block[i], true);
+        }, [this, block](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) { ClusterCoreSecondPhase(block[i]); }
+        });
+        is_stopped = !PublishAnytimeProgress("cluster-core", b + 1, beta_block_num, false, elapsed_ms(), budget_ms,
+                                             callback);
+    }
+
+    if (is_stopped) {
+        MaterializeApproximation();
+        cout << "anytime, stopped at " << elapsed_ms() << " ms, approximate result\n";
+    } else {
+        pSCANFourthPhaseClusterNonCore();
+        PublishAnytimeProgress("cluster-non-core", 1, 1, true, elapsed_ms(), budget_ms, callback);
+    }
+    ReportSimilarityComputations(undecided_after_prune);
+}
@@ -0,0 +1,39 @@
+#ifndef PPSCAN_ANYTIME_H
+#define PPSCAN_ANYTIME_H
+
+#include <algorithm>
+#include <functional>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * anytime engine (anySCAN-style): check-core runs in alpha blocks of undecided vertices and core clustering in beta
+ * blocks of cores, each block in parallel with the release kernels; after every block the current approximation
+ * is published, without a stop the result is the exact ppSCAN one
+ */
+constexpr ui DEFAULT_ALPHA_BLOCK_SIZE = 8192;
+constexpr ui DEFAULT_BETA_BLOCK_SIZE = 8192;
+
+// blocks of a stage at most, the block sizes grow with the graph: every publication is an O(n) pass
+constexpr ui MAX_ANYTIME_BLOCK_NUM = 64;
+
+inline ui AnytimeBlockSize(ui block_size, ui item_num) {
+    return max(block_size, (item_num + MAX_ANYTIME_BLOCK_NUM - 1) / MAX_ANYTIME_BLOCK_NUM);
+}
+
+struct AnytimeProgress {
+    const char *stage;      // prune, check-core, cluster-core, cluster-non-core
+    ui block;               // blocks done in the stage
+    ui block_num;
+    double elapsed_ms;
+    ui decided_num;         // vertices with a definite core status
+    ui core_num;            // definite cores
+    ui core_cluster_num;    // sets of the definite cores: the clusters of the current approximation
+    bool is_exact;
+};
+
+// called after every block, returning false stops at this block boundary
+using AnytimeCallback = function<bool(const AnytimeProgress &)>;
+
+#endif //PPSCAN_ANYTIME_H
@@ -0,0 +1,257 @@
+#include "AutoTuner.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "Graph.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+// probes: repeated until PROBE_MIN_TIME, best of PROBE_ROUNDS; sample: every TUNE_SAMPLE_STRIDE-th vertex
+constexpr double PROBE_MIN_TIME = 0.02;
+constexpr int PROBE_ROUNDS = 3;
+constexpr ui TUNE_SAMPLE_STRIDE = 16;
+
+const char *KernelName(IntersectKernel kernel) {
+    switch (kernel) {
+        case IntersectKernel::SSE:
+            return "SSE";
+        case IntersectKernel::AVX2:
+            return "AVX2";
+        case IntersectKernel::AVX2_MERGE:
+            return "AVX2_MERGE";
+        case IntersectKernel::AVX512:
+            return "AVX512";
+        case IntersectKernel::AVX512_NO_DU_DV:
+            return "AVX512_NO_DU_DV";
+        case IntersectKernel::AVX512_MERGE:
+            return "AVX512_MERGE";
+        default:
+            return "SCALAR";
+    }
+}
+
+vector<IntersectKernel> AvailableKernels() {
+#if defined(ENABLE_KERNEL_DISPATCH)
+    vector<IntersectKernel> kernels{IntersectKernel::SCALAR, IntersectKernel::SSE};
+#if defined(ENABLE_AVX2)
+    kernels.emplace_back(IntersectKernel::AVX2);
+#endif
+#if defined(ENABLE_AVX2_MERGE)
+    kernels.emplace_back(IntersectKernel::AVX2_MERGE);
+#endif
+#if defined(ENABLE_AVX512)
+    kernels.emplace_back(IntersectKernel::AVX512);
+#endif
+#if defined(ENABLE_AVX512_NO_DU_DV)
+    kernels.emplace_back(IntersectKernel::AVX512_NO_DU_DV);
+#endif
+#if defined(ENABLE_AVX512_MERGE)
+    kernels.emplace_back(IntersectKernel::AVX512_MERGE);
+#endif
+    return kernels;
+#else
+    return vector<IntersectKernel>{DefaultKernel()};
+#endif
+}
+
+// the same priority as the static selection in Graph::IntersectSelectedKernel
+IntersectKernel DefaultKernel() {
+#if defined(ENABLE_AVX512)
+    return IntersectKernel::AVX512;
+#elif defined(ENABLE_AVX512_NO_DU_DV)
+    return IntersectKernel::AVX512_NO_DU_DV;
+#elif defined(ENABLE_AVX512_MERGE)
+    return IntersectKernel::AVX512_MERGE;
+#elif defined(ENABLE_AVX2)
+    return IntersectKernel::AVX2;
+#elif defined(ENABLE_AVX2_MERGE)
+    return IntersectKernel::AVX2_MERGE;
+#elif defined(ENABLE_SSE)
+    return IntersectKernel::SSE;
+#else
+    return IntersectKernel::SCALAR;
+#endif
+}
+
+static string HostName() {
+    char host_name[256];
+    if (gethostname(host_name, sizeof(host_name)) != 0) { return "unknown"; }
+    host_name[sizeof(host_name) - 1] = '\0';
+    return string(host_name);
+}
+
+// eps as written to the profile, compared as text: the default stream precision rounds
+static string EpsText(double eps) {
+    ostringstream eps_text;
+    eps_text << eps;
+    return eps_text.str();
+}
+
+string TuneProfilePath(const string &dir, double eps, int min_u) {
+    return dir + "/tune-profile-" + HostName() + "-" + EpsText(eps) + "-" + to_string(min_u) + ".txt";
+}
+
+bool LoadTuneProfile(const string &dir, ui n, ui m, double eps, int min_u, TuneProfile &profile) {
+    auto path = TuneProfilePath(dir, eps, min_u);
+    ifstream ifs(path);
+    if (!ifs.good()) { return false; }
+
+    TuneProfile loaded = profile;
+    string key, value, kernel_name;
+    ui profile_n = 0, profile_m = 0;
+    string profile_eps;
+    auto profile_min_u = -1;
+    while (ifs >> key >> value) {
+        if (key == "n") {
+            profile_n = static_cast<ui>(stoul(value));
+        } else if (key == "m") {
+            profile_m = static_cast<ui>(stoul(value));
+        } else if (key == "eps") {
+            profile_eps = value;
+        } else if (key == "mu") {
+            profile_min_u = stoi(value);
+        } else if (key == "thread_num") {
+            loaded.schedule.thread_num = stoul(value);
+        } else if (key == "tasks_per_thread") {
+            loaded.schedule.tasks_per_thread = stol(value);
+        } else if (key == "min_task_cost") {
+            loaded.schedule.min_task_cost = stol(value);
+        } else if (key == "kernel") {
+            kernel_name = value;
+        }
+    }
+    if (profile_n != n || profile_m != m || profile_eps != EpsText(eps) || profile_min_u != min_u ||
+        loaded.schedule.thread_num == 0) {
+        cout << "tune profile " << path << " does not match the graph and parameters, ignored\n";
+        return false;
+    }
+    // a kernel not compiled into this binary keeps the default one
+    for (auto kernel: AvailableKernels()) {
+        if (kernel_name == KernelName(kernel)) { loaded.kernel = kernel; }
+    }
+    profile = loaded;
+    return true;
+}
+
+void SaveTuneProfile(const string &dir, ui n, ui m, double eps, int min_u, const TuneProfile &profile) {
+    ofstream ofs(TuneProfilePath(dir, eps, min_u));
+    ofs << "host " << HostName() << "\n"
+        << "n " << n << "\n"
+        << "m " << m << "\n"
+        << "eps " << EpsText(eps) << "\n"
+        << "mu " << min_u << "\n"
+        << "thread_num " << profile.schedule.thread_num << "\n"
+        << "tasks_per_thread " << profile.schedule.tasks_per_thread << "\n"
+        << "min_task_cost " << profile.schedule.min_task_cost << "\n"
+        << "kernel " << KernelName(profile.kernel) << "\n";
+}
+
+double Graph::ProbeCheckCore(const vector<int> &sample) {
+    auto schedule = profile.schedule;
+    schedule.is_report = false;
+    atomic<long> similar_num(0);
+    auto probe_once = [&, this]() {
+        ExecuteLongestFirst("probe", schedule, static_cast<ui>(sample.size()), [&, this](ui i) -> long {
+            return EstimateCheckCoreCost(sample[i], true);
+        }, [&, this](ui i_start, ui i_end) {
+            // read-only: intersections of the undecided edges, results are only counted
+            long local_similar_num = 0;
+            for (auto i = i_start; i < i_end; i++) {
+                auto u = sample[i];
+                for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                    if (u <= out_edges[edge_idx] && min_cn[edge_idx] > 0) {
+                        local_similar_num += EvalSimilarity(u, edge_idx) == SIMILAR ? 1 : 0;
+                    }
+                }
+            }
+            similar_num += local_similar_num;
+        });
+    };
+
+    // calibrate the repetitions of one round, then keep the best round
+    auto repeat = 1;
+    while (true) {
+        auto start = high_resolution_clock::now();
+        for (auto r = 0; r < repeat; r++) { probe_once(); }
+        if (duration<double>(high_resolution_clock::now() - start).count() >= PROBE_MIN_TIME || repeat >= 1024) {
+            break;
+        }
+        repeat *= 2;
+    }
+    auto best = numeric_limits<double>::max();
+    for (auto round = 0; round < PROBE_ROUNDS; round++) {
+        auto start = high_resolution_clock::now();
+        for (auto r = 0; r < repeat; r++) { probe_once(); }
+        best = min(best, duration<double>(high_resolution_clock::now() - start).count() / repeat);
+    }
+    log_info("probe similar num: %ld", similar_num.load());
+    return best;
+}
+
+void Graph::AutoTune() {
+    auto tune_start = high_resolution_clock::now();
+    // probes run on the check-core workload, the dominant phase, after pruning
+    pSCANFirstPhasePrune();
+    vector<int> sample;
+    auto unknown_num = count(core_status_lst.begin(), core_status_lst.end(), UN_KNOWN);
+    auto stride = unknown_num < 16 * 1024 ? 1u : TUNE_SAMPLE_STRIDE;
+    for (auto u = 0u, unknown_idx = 0u; u < n; u++) {
+        if (core_status_lst[u] == UN_KNOWN && (unknown_idx++) % stride == 0) { sample.emplace_back(u); }
+    }
+    cout << "tune sample size:" << sample.size() << "\n";
+
+    auto best_time = ProbeCheckCore(sample);
+    auto try_candidate = [&, this](const TuneProfile &candidate) {
+        auto previous = profile;
+        profile = candidate;
+        auto time = ProbeCheckCore(sample);
+        cout << "probe kernel:" << KernelName(candidate.kernel) << ", threads:" << candidate.schedule.thread_num
+             << ", tasks per thread:" << candidate.schedule.tasks_per_thread << ", min task cost:"
+             << candidate.schedule.min_task_cost << ", time:" << time * 1000 << " ms\n";
+        if (time < best_time) {
+            best_time = time;
+        } else {
+            profile = previous;
+        }
+    };
+
+    // coordinate search: kernel, then thread count, then granularity
+    for (auto kernel: AvailableKernels()) {
+        auto candidate = profile;
+        candidate.kernel = kernel;
+        try_candidate(candidate);
+    }
+    auto max_threads = max<size_t>(1, std::thread::hardware_concurrency());
+    vector<size_t> thread_nums;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) { thread_nums.emplace_back(threads); }
+    thread_nums.emplace_back(max_threads);
+    for (auto threads: thread_nums) {
+        auto candidate = profile;
+        candidate.schedule.thread_num = threads;
+        try_candidate(candidate);
+    }
+    for (auto tasks_per_thread: {4l, 16l, 64l, 256l}) {
+        for (auto min_task_cost: {4 * 1024l, 32 * 1024l, 256 * 1024l}) {
+            auto candidate = profile;
+            candidate.schedule.tasks_per_thread = tasks_per_thread;
+            candidate.schedule.min_task_cost = min_task_cost;
+            try_candidate(candidate);
+        }
+    }
+
+    SaveTuneProfile(dir, n, static_cast<ui>(io_helper_ptr->m), eps, min_u, profile);
+    auto tune_end = high_resolution_clock::now();
+    cout << "tuned kernel:" << KernelName(profile.kernel) << ", threads:" << profile.schedule.thread_num
+         << ", tasks per thread:" << profile.schedule.tasks_per_thread << ", min task cost:"
+         << profile.schedule.min_task_cost << ", saved to " << TuneProfilePath(dir, eps, min_u) << "\n";
+    cout << "auto-tune time:" << duration_cast<milliseconds>(tune_end - tune_start).count() << " ms\n";
+}
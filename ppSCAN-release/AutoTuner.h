@@ -0,0 +1,37 @@
+#ifndef PPSCAN_AUTO_TUNER_H
+#define PPSCAN_AUTO_TUNER_H
+
+#include <string>
+#include <vector>
+
+#include "TaskScheduler.h"
+
+using namespace std;
+
+// set-intersection kernels, see SetIntersection.cpp
+enum class IntersectKernel : int {
+    SCALAR = 0, SSE = 1, AVX2 = 2, AVX2_MERGE = 3, AVX512 = 4, AVX512_NO_DU_DV = 5, AVX512_MERGE = 6
+};
+
+const char *KernelName(IntersectKernel kernel);
+
+// kernels compiled into this binary: all enabled ones with ENABLE_KERNEL_DISPATCH, otherwise the single static one
+vector<IntersectKernel> AvailableKernels();
+
+IntersectKernel DefaultKernel();
+
+// tuned parameters, a profile is specific to the machine (host name), the graph (directory, n, m) and the parameters
+// (eps, mu), which decide how much check-core work the pruning leaves to the probes
+struct TuneProfile {
+    ScheduleConfig schedule;
+    IntersectKernel kernel = DefaultKernel();
+};
+
+// profile file: <graph-dir>/tune-profile-<host-name>-<eps>-<mu>.txt, "key value" per line
+string TuneProfilePath(const string &dir, double eps, int min_u);
+
+bool LoadTuneProfile(const string &dir, ui n, ui m, double eps, int min_u, TuneProfile &profile);
+
+void SaveTuneProfile(const string &dir, ui n, ui m, double eps, int min_u, const TuneProfile &profile);
+
+#endif //PPSCAN_AUTO_TUNER_H
@@ -0,0 +1,75 @@
+#ifndef PPSCAN_BUCKET_SIGNATURE_H
+#define PPSCAN_BUCKET_SIGNATURE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <immintrin.h>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * bucket-histogram signatures: the closed neighborhood of a vertex counted in k vertex-id ranges,
+ * |N[u] ∩ N[v]| <= sum_b min(cnt_u[b], cnt_v[b]), so a bound below min_cn proves NOT_SIMILAR without a merge
+ */
+constexpr ui DEFAULT_SIGNATURE_BUCKETS = 16;
+constexpr ui SIGNATURE_BUCKET_ALIGN = 16;       // uint16 lanes of an avx2 register
+constexpr int SIGNATURE_COUNT_MAX = UINT16_MAX; // counts saturate, the bound holds if one side did not
+
+class BucketSignatures {
+public:
+    ui bucket_num;
+    ui bucket_width;
+    vector<uint16_t> counts;    // n rows of bucket_num counts
+
+    BucketSignatures(ui n, ui bucket_num) :
+            bucket_num((max(bucket_num, 1u) + SIGNATURE_BUCKET_ALIGN - 1) / SIGNATURE_BUCKET_ALIGN *
+                       SIGNATURE_BUCKET_ALIGN),
+            bucket_width((n + this->bucket_num - 1) / this->bucket_num),
+            counts(static_cast<size_t>(n) * this->bucket_num, 0) {}
+
+    uint16_t *Row(int u) { return &counts[static_cast<size_t>(u) * bucket_num]; }
+
+    void Add(uint16_t *row, int v) {
+        auto &count = row[static_cast<ui>(v) / bucket_width];
+        if (count < SIGNATURE_COUNT_MAX) { ++count; }
+    }
+
+    int UpperBound(int u, int v) const {
+        auto row_u = &counts[static_cast<size_t>(u) * bucket_num];
+        auto row_v = &counts[static_cast<size_t>(v) * bucket_num];
+        auto bound = 0;
+#if defined(__AVX2__)
+        auto zero = _mm256_setzero_si256();
+        auto acc = _mm256_setzero_si256();
+        for (auto b = 0u; b < bucket_num; b += 16) {
+            auto min_cnt = _mm256_min_epu16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_u + b)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_v + b)));
+            acc = _mm256_add_epi32(acc, _mm256_add_epi32(_mm256_unpacklo_epi16(min_cnt, zero),
+                                                         _mm256_unpackhi_epi16(min_cnt, zero)));
+        }
+        alignas(32) int partial[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(partial), acc);
+        for (auto p: partial) { bound += p; }
+#elif defined(__SSE4_1__)
+        auto zero = _mm_setzero_si128();
+        auto acc = _mm_setzero_si128();
+        for (auto b = 0u; b < bucket_num; b += 8) {
+            auto min_cnt = _mm_min_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row_u + b)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i *>(row_v + b)));
+            acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_unpacklo_epi16(min_cnt, zero),
+                                                   _mm_unpackhi_epi16(min_cnt, zero)));
+        }
+        alignas(16) int partial[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(partial), acc);
+        for (auto p: partial) { bound += p; }
+#else
+        for (auto b = 0u; b < bucket_num; b++) { bound += min(row_u[b], row_v[b]); }
+#endif
+        return bound;
+    }
+};
+
+#endif //PPSCAN_BUCKET_SIGNATURE_H
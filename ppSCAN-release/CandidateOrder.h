@@ -0,0 +1,34 @@
+#ifndef PPSCAN_CANDIDATE_ORDER_H
+#define PPSCAN_CANDIDATE_ORDER_H
+
+#include <cstring>
+
+/*
+ * evaluation order of the undecided edges of a vertex, the loops stop as soon as the vertex is decided
+ * (check-core) or the pair is already in the same set (core clustering), see Graph::CandidatePriority
+ */
+enum class CandidateOrder : int {
+    ADJACENCY = 0,      // neighbor id order, no ordering step
+    CHEAPEST = 1,       // smallest neighbor degree first: cheapest merges
+    LIKELY_SIMILAR = 2  // smallest min_cn relative to the smaller degree first
+};
+
+inline const char *CandidateOrderName(CandidateOrder order) {
+    switch (order) {
+        case CandidateOrder::CHEAPEST:
+            return "cheapest";
+        case CandidateOrder::LIKELY_SIMILAR:
+            return "likely-similar";
+        default:
+            return "adjacency";
+    }
+}
+
+inline CandidateOrder ParseCandidateOrder(const char *name) {
+    for (auto order: {CandidateOrder::CHEAPEST, CandidateOrder::LIKELY_SIMILAR}) {
+        if (strcmp(name, CandidateOrderName(order)) == 0) { return order; }
+    }
+    return CandidateOrder::ADJACENCY;
+}
+
+#endif //PPSCAN_CANDIDATE_ORDER_H
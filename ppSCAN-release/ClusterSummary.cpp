@@ -0,0 +1,191 @@
+#include "Graph.h"
+
+#include <numeric>
+
+#include "util/log/log.h"
+
+using namespace std::chrono;
+
+bool Graph::IsClusteredCore(int u) {
+    return compact_ptr != nullptr ? compact_ptr->IsCore(u) : IsDefiniteCoreVertex(u);
+}
+
+int Graph::ClusterRoot(int u) {
+    return compact_ptr != nullptr ? static_cast<int>(compact_ptr->disjoint_sets.FindRoot(static_cast<uint32_t>(u)))
+                                  : static_cast<int>(disjoint_set_ptr->FindRoot(static_cast<uint32_t>(u)));
+}
+
+void Graph::BuildClusterSummary() {
+    auto start = high_resolution_clock::now();
+    auto thread_num = profile.schedule.thread_num;
+    auto core_num = static_cast<ui>(cores.size());
+    summary = ClusterSummary();
+    auto &dense_id = summary.dense_id;
+    dense_id.assign(n, -1);
+
+    // 1st: minimum core of each set, keyed by the root
+    vector<int> cluster_min(n, n);
+    ParallelForStatic(thread_num, core_num, [this, &cluster_min](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            if (!IsClusteredCore(u)) { continue; }
+            auto &x = cluster_min[ClusterRoot(u)];
+            int cluster_min_ele;
+            do {
+                cluster_min_ele = x;
+                if (u >= cluster_min_ele) { break; }
+            } while (!__sync_bool_compare_and_swap(&x, cluster_min_ele, u));
+        }
+    });
+
+    // 2nd: dense id = rank of the minimum core among the minimum cores, a prefix sum over the vertex ids
+    vector<ui> rank(n + 1, 0);
+    ParallelForStatic(thread_num, n, [this, &cluster_min, &rank](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            if (IsClusteredCore(u) && cluster_min[ClusterRoot(u)] == static_cast<int>(u)) { rank[u] = 1; }
+        }
+    });
+    ParallelExclusiveScan(thread_num, rank);
+    summary.cluster_num = rank[n];
+    ParallelForStatic(thread_num, core_num, [this, &cluster_min, &rank, &dense_id](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            if (IsClusteredCore(u)) { dense_id[u] = static_cast<int>(rank[cluster_min[ClusterRoot(u)]]); }
+        }
+    });
+    vector<int>().swap(cluster_min);
+    vector<ui>().swap(rank);
+
+    // 3rd: core counts
+    summary.core_num.assign(summary.cluster_num, 0);
+    ParallelForStatic(thread_num, core_num, [this, &dense_id](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            if (dense_id[cores[i]] >= 0) { __sync_fetch_and_add(&summary.core_num[dense_id[cores[i]]], 1); }
+        }
+    });
+
+    // 4th: non-core memberships bucketed by vertex (count, prefix sum, scatter), then deduplicated per vertex;
+    // the cluster id of a pair is a core of the cluster in every mode
+    auto pair_num = static_cast<ui>(noncore_cluster.size());
+    vector<ui> pair_start(n + 1, 0);
+    ParallelForStatic(thread_num, pair_num, [this, &pair_start](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) { __sync_fetch_and_add(&pair_start[noncore_cluster[i].second], 1); }
+    });
+    ParallelExclusiveScan(thread_num, pair_start);
+    vector<int> pair_clusters(pair_num);
+    {
+        vector<ui> cursor(pair_start.begin(), pair_start.end() - 1);
+        ParallelForStatic(thread_num, pair_num, [this, &cursor, &pair_clusters, &dense_id](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) {
+                auto pos = __sync_fetch_and_add(&cursor[noncore_cluster[i].second], 1);
+                pair_clusters[pos] = dense_id[noncore_cluster[i].first];
+            }
+        });
+    }
+    auto &member_start = summary.member_start;
+    member_start.assign(n + 1, 0);
+    ParallelForStatic(thread_num, n, [&pair_start, &pair_clusters, &member_start](ui i_start, ui i_end) {
+        for (auto v = i_start; v < i_end; v++) {
+            auto beg = pair_clusters.begin() + pair_start[v], end = pair_clusters.begin() + pair_start[v + 1];
+            sort(beg, end);
+            member_start[v] = static_cast<ui>(unique(beg, end) - beg);
+        }
+    });
+    ParallelExclusiveScan(thread_num, member_start);
+    summary.member_clusters.resize(member_start[n]);
+    summary.non_core_num.assign(summary.cluster_num, 0);
+    summary.shared_non_core_num = ParallelReduce(thread_num, n, 0u, [this, &pair_start, &pair_clusters](
+            ui i_start, ui i_end) {
+        auto local_shared = 0u;
+        for (auto v = i_start; v < i_end; v++) {
+            auto member_num = summary.member_start[v + 1] - summary.member_start[v];
+            for (auto j = 0u; j < member_num; j++) {
+                auto cluster = pair_clusters[pair_start[v] + j];
+                summary.member_clusters[summary.member_start[v] + j] = cluster;
+                __sync_fetch_and_add(&summary.non_core_num[cluster], 1);
+            }
+            if (member_num > 1) { ++local_shared; }
+        }
+        return local_shared;
+    });
+    summary.non_core_member_num = ParallelReduce(thread_num, n, 0u, [this](ui i_start, ui i_end) {
+        auto local_num = 0u;
+        for (auto v = i_start; v < i_end; v++) {
+            if (summary.member_start[v + 1] > summary.member_start[v]) { ++local_num; }
+        }
+        return local_num;
+    });
+
+    // 5th: size histogram, per chunk then merged
+    summary.size_histogram.assign(SIZE_HISTOGRAM_BUCKETS, 0);
+    ParallelForStatic(thread_num, summary.cluster_num, [this](ui i_start, ui i_end) {
+        ui local_histogram[SIZE_HISTOGRAM_BUCKETS] = {0};
+        for (auto c = i_start; c < i_end; c++) { ++local_histogram[ClusterSummary::HistogramBucket(summary.Size(c))]; }
+        for (auto b = 0u; b < SIZE_HISTOGRAM_BUCKETS; b++) {
+            if (local_histogram[b] > 0) { __sync_fetch_and_add(&summary.size_histogram[b], local_histogram[b]); }
+        }
+    });
+
+    auto end = high_resolution_clock::now();
+    cout << "cluster summary, clusters:" << summary.cluster_num << ", non-core members:"
+         << summary.non_core_member_num << ", shared non-cores:" << summary.shared_non_core_num << ", time:"
+         << duration_cast<milliseconds>(end - start).count() << " ms\n";
+}
+
+void Graph::ClassifyHubsOutliers() {
+    if (summary.dense_id.empty()) { BuildClusterSummary(); }
+    auto start = high_resolution_clock::now();
+    auto &role = summary.role;
+    role.assign(n, OUTLIER);
+
+    // an unclustered vertex is a hub as soon as a neighbor's cluster differs from the first one seen
+    summary.hub_num = ParallelReduce(profile.schedule.thread_num, n, 0u, [this, &role](ui i_start, ui i_end) {
+        auto local_hub_num = 0u;
+        for (auto v = i_start; v < i_end; v++) {
+            if (summary.dense_id[v] >= 0) {
+                role[v] = CORE_MEMBER;
+                continue;
+            }
+            if (summary.member_start[v + 1] > summary.member_start[v]) {
+                role[v] = NON_CORE_MEMBER;
+                continue;
+            }
+            auto first_cluster = -1;
+            for (auto edge_idx = out_edge_start[v]; edge_idx < out_edge_start[v + 1] && role[v] != HUB; edge_idx++) {
+                auto u = out_edges[edge_idx];
+                auto clusters_beg = summary.dense_id[u] >= 0 ? &summary.dense_id[u] :
+                                    summary.member_clusters.data() + summary.member_start[u];
+                auto clusters_end = summary.dense_id[u] >= 0 ? clusters_beg + 1 :
+                                    summary.member_clusters.data() + summary.member_start[u + 1];
+                for (auto it = clusters_beg; it < clusters_end; it++) {
+                    if (first_cluster < 0) {
+                        first_cluster = *it;
+                    } else if (*it != first_cluster) {
+                        role[v] = HUB;
+                        ++local_hub_num;
+                        break;
+                    }
+                }
+            }
+        }
+        return local_hub_num;
+    });
+    summary.outlier_num = n - accumulate(summary.core_num.begin(), summary.core_num.end(), 0u) -
+                          summary.non_core_member_num - summary.hub_num;
+
+    auto end = high_resolution_clock::now();
+    cout << "hub/outlier classification, hubs:" << summary.hub_num << ", outliers:" << summary.outlier_num
+         << ", time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
+}
+
+const ClusterSummary &Graph::GetClusterSummary() const {
+    return summary;
+}
+
+void Graph::OutputRoles(const char *eps_s, const char *miu) {
+    io_helper_ptr->OutputRoles(eps_s, miu, summary);
+}
+
+void Graph::OutputSummary(const char *eps_s, const char *miu) {
+    io_helper_ptr->OutputSummary(eps_s, miu, summary);
+}
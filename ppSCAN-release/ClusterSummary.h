@@ -0,0 +1,51 @@
+#ifndef PPSCAN_CLUSTER_SUMMARY_H
+#define PPSCAN_CLUSTER_SUMMARY_H
+
+#include <vector>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * clusters relabelled densely to [0, cluster_num) in the order of their minimum core id (deterministic across
+ * engines and thread numbers), with the per-cluster statistics; built in parallel from the run's results
+ */
+constexpr ui SIZE_HISTOGRAM_BUCKETS = 32;
+
+// role of a vertex after hub/outlier classification: a hub is outside every cluster and adjacent to 2+ clusters
+enum VertexRole : char {
+    CORE_MEMBER = 0, NON_CORE_MEMBER = 1, HUB = 2, OUTLIER = 3
+};
+
+struct ClusterSummary {
+    ui cluster_num = 0;
+    vector<int> dense_id;           // per vertex: dense cluster id of a core, -1 for a non-core
+
+    // non-core v belongs to the clusters member_clusters[member_start[v], member_start[v + 1]), ascending, distinct
+    vector<ui> member_start;
+    vector<int> member_clusters;
+
+    vector<ui> core_num;            // per cluster
+    vector<ui> non_core_num;        // per cluster, distinct non-core members
+    vector<ui> size_histogram;      // bucket b: clusters with size in [2^b, 2^(b + 1))
+    ui non_core_member_num = 0;     // non-cores in at least one cluster
+    ui shared_non_core_num = 0;     // non-cores in several clusters
+
+    // empty until classified
+    vector<char> role;
+    ui hub_num = 0;
+    ui outlier_num = 0;
+
+    ui Size(ui cluster) const { return core_num[cluster] + non_core_num[cluster]; }
+
+    static ui HistogramBucket(ui size) {
+        ui bucket = 0;
+        while (size > 1) {
+            size >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+};
+
+#endif //PPSCAN_CLUSTER_SUMMARY_H
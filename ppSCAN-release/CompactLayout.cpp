@@ -0,0 +1,183 @@
+#include "Graph.h"
+
+#include <algorithm>
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+ui Graph::UndirectedEdgeId(int u, ui edge_idx) {
+    auto v = out_edges[edge_idx];
+    if (u > v) {
+        edge_idx = BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u);
+        u = v;
+    }
+    // the edges to larger neighbors are the suffix of the sorted adjacency
+    return compact_ptr->upper_start[u + 1] - (out_edge_start[u + 1] - edge_idx);
+}
+
+void Graph::CompactUpdateDegree(int u, int result) {
+    if (result == SIMILAR) {
+        if (__sync_add_and_fetch(&similar_degree[u], 1) == min_u) { compact_ptr->SetCore(u); }
+    } else {
+        if (__sync_sub_and_fetch(&effective_degree[u], 1) == min_u - 1) { compact_ptr->SetNonCore(u); }
+    }
+}
+
+int Graph::CompactComputeOnce(int u, ui edge_idx, bool is_wait) {
+    auto v = out_edges[edge_idx];
+    // the pruning state is recomputed from the degrees, only undecided edges have a stored state
+    auto min_cn_num = PruneState(u, edge_idx);
+    if (min_cn_num < 0) { return min_cn_num; }
+
+    auto id = UndirectedEdgeId(u, edge_idx);
+    auto is_conflict = false;
+    while (true) {
+        auto state = compact_ptr->EdgeState(id);
+        if (state == EDGE_SIMILAR) { return SIMILAR; }
+        if (state == EDGE_NOT_SIMILAR) { return NOT_SIMILAR; }
+        if (state == EDGE_IN_PROGRESS) {
+            if (!is_conflict) {
+                is_conflict = true;
+                __sync_fetch_and_add(&claim_conflicts, 1);
+            }
+            if (!is_wait) { return IN_PROGRESS; }
+            continue;
+        }
+        if (compact_ptr->ClaimEdge(id)) {
+            auto result = EvalSimilarity(u, edge_idx, min_cn_num);
+            __sync_fetch_and_add(&similarity_computations, 1);
+            compact_ptr->PublishEdge(id, result == SIMILAR ? EDGE_SIMILAR : EDGE_NOT_SIMILAR);
+            CompactUpdateDegree(u, result);
+            CompactUpdateDegree(v, result);
+            return result;
+        }
+    }
+}
+
+void Graph::CompactCheckCore(int u, bool is_first_bsp) {
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        if (compact_ptr->IsCore(u) || compact_ptr->IsNonCore(u)) { return; }
+        auto v = out_edges[edge_idx];
+        if (!is_first_bsp || u <= v) { CompactComputeOnce(u, edge_idx, false); }
+    }
+}
+
+void Graph::ReportBytesPerEdge() {
+    auto m = static_cast<double>(out_edge_start[n]);
+    auto undirected_m = m / 2;
+    // shared by both layouts: out_edges, out_edge_start, sd/ed counters
+    auto shared_bytes = m * sizeof(int) + (n + 1.0) * sizeof(ui) + 2.0 * n * sizeof(int);
+    auto compact_bytes = shared_bytes + compact_ptr->Bytes();
+    // standard layout: min_cn per directed edge, char status, 8-byte disjoint sets, cluster_dict
+    auto standard_bytes = shared_bytes + m * sizeof(int) + n * (sizeof(char) + sizeof(uint64_t) + sizeof(int));
+    cout << "bytes per undirected edge, compact layout:" << compact_bytes / undirected_m << ", standard layout:"
+         << standard_bytes / undirected_m << "\n";
+}
+
+void Graph::pSCANCompact() {
+    // hub edges stay in the task of their vertex, the compact states have no split intersections
+    cout << "new algorithm ppSCAN (compact layout, no hub splitting), runtime:" << RuntimeName() << ", threads:"
+         << profile.schedule.thread_num << ", similarity:" << Similarity::NAME << endl;
+    auto start = high_resolution_clock::now();
+
+    // undirected edge ids
+    vector<ui> upper_start(n + 1, 0);
+    ParallelForStatic(profile.schedule.thread_num, n, [this, &upper_start](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            upper_start[u] = static_cast<ui>(out_edges.begin() + out_edge_start[u + 1] -
+                                             upper_bound(out_edges.begin() + out_edge_start[u],
+                                                         out_edges.begin() + out_edge_start[u + 1], u));
+        }
+    });
+    ParallelExclusiveScan(profile.schedule.thread_num, upper_start);
+    glue_edge_ids_time += duration<double>(high_resolution_clock::now() - start).count();
+    compact_ptr = yche::make_unique<CompactLayout>(n, std::move(upper_start));
+    ReportBytesPerEdge();
+
+    // 1st: prune, the states are not stored but recomputed on demand
+    ExecuteLongestFirst("1st: compact prune", profile.schedule, n, [this](ui u) -> long {
+        return Degree(u);
+    }, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            auto sd = 0;
+            auto ed = Degree(u) - 1;
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto state = PruneState(u, edge_idx);
+                if (state == SIMILAR) { ++sd; } else if (state == NOT_SIMILAR) { --ed; }
+            }
+            similar_degree[u] = sd;
+            effective_degree[u] = ed;
+            if (sd >= min_u) {
+                compact_ptr->SetCore(u);
+            } else if (ed < min_u) {
+                compact_ptr->SetNonCore(u);
+            }
+        }
+    });
+    auto prune_end = high_resolution_clock::now();
+    cout << "1st: compact prune time:" << duration_cast<milliseconds>(prune_end - start).count() << " ms\n";
+
+    // 2nd: check core, two rounds as in pSCAN, edges claimed in the 2-bit states
+    for (auto is_first_bsp: {true, false}) {
+        ExecuteLongestFirst(is_first_bsp ? "2nd: compact check core first-phase bsp" :
+                            "2nd: compact check core second-phase bsp", profile.schedule, n, [this](ui u) -> long {
+            return compact_ptr->IsCore(u) || compact_ptr->IsNonCore(u) ? 0 : Degree(u);
+        }, [this, is_first_bsp](ui i_start, ui i_end) {
+            for (auto u = i_start; u < i_end; u++) { CompactCheckCore(u, is_first_bsp); }
+        });
+    }
+    auto check_core_end = high_resolution_clock::now();
+    cout << "2nd: compact check core time:" << duration_cast<milliseconds>(check_core_end - prune_end).count()
+         << " ms\n";
+
+    // 3rd: cluster core
+    ParallelSelect(profile.schedule.thread_num, n, [this](ui u) { return compact_ptr->IsCore(u); }, cores);
+    glue_select_cores_time += duration<double>(high_resolution_clock::now() - check_core_end).count();
+    cout << "core size:" << cores.size() << "\n";
+    auto &disjoint_sets = compact_ptr->disjoint_sets;
+    ExecuteLongestFirst("3rd: compact cluster core", profile.schedule, static_cast<ui>(cores.size()),
+                        [this](ui i) -> long {
+                            return Degree(cores[i]);
+                        }, [this, &disjoint_sets](ui i_start, ui i_end) {
+                for (auto i = i_start; i < i_end; i++) {
+                    auto u = cores[i];
+                    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                        auto v = out_edges[edge_idx];
+                        if (u < v && compact_ptr->IsCore(v) &&
+                            !disjoint_sets.IsSameSet(static_cast<uint32_t>(u), static_cast<uint32_t>(v)) &&
+                            CompactComputeOnce(u, edge_idx, true) == SIMILAR) {
+                            disjoint_sets.Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+                        }
+                    }
+                }
+            });
+    auto cluster_core_end = high_resolution_clock::now();
+    cout << "3rd: compact core clustering time:"
+         << duration_cast<milliseconds>(cluster_core_end - check_core_end).count() << " ms\n";
+
+    // 4th: cluster non-core, the root of a core's set is the minimum core of the cluster
+    auto bound_start = high_resolution_clock::now();
+    auto pair_bound = NonCorePairBound();
+    noncore_cluster = std::vector<pair<int, int>>();
+    glue_non_core_output_time += duration<double>(high_resolution_clock::now() - bound_start).count();
+    CollectNonCoreClusters("4th: compact cluster non-core", pair_bound, [this](ui i) -> long {
+        return Degree(cores[i]);
+    }, [this, &disjoint_sets](ui i, NonCoreWriter &writer) {
+        auto u = cores[i];
+        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+            auto v = out_edges[edge_idx];
+            if (!compact_ptr->IsCore(v) && CompactComputeOnce(u, edge_idx, true) == SIMILAR) {
+                writer.push(make_pair(static_cast<int>(disjoint_sets.FindRoot(static_cast<uint32_t>(u))), v));
+            }
+        }
+    });
+    auto all_end = high_resolution_clock::now();
+    cout << "4th: compact non-core clustering time:"
+         << duration_cast<milliseconds>(all_end - cluster_core_end).count() << " ms\n";
+    cout << "similarity computations:" << similarity_computations << ", claim conflicts:" << claim_conflicts
+         << ", signature-pruned:" << signature_pruned << "\n";
+    ReportGlueBreakdown(duration<double>(all_end - start).count());
+}
@@ -0,0 +1,80 @@
+#ifndef PPSCAN_COMPACT_LAYOUT_H
+#define PPSCAN_COMPACT_LAYOUT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ThreadSafeDisjointSet.h"
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * compact layout for billion-edge graphs:
+ * 2 bits of state per undirected edge instead of 4 bytes per directed edge, thresholds recomputed from the degrees,
+ * core/non-core status as 2 bitsets, 4-byte disjoint sets whose roots are the cluster ids (no cluster_dict)
+ */
+constexpr uint64_t EDGE_UNKNOWN = 0;
+constexpr uint64_t EDGE_SIMILAR = 1;
+constexpr uint64_t EDGE_NOT_SIMILAR = 2;
+constexpr uint64_t EDGE_IN_PROGRESS = 3;
+
+class CompactLayout {
+public:
+    // undirected edge ids: the edges (u, v), u < v, of u are [upper_start[u], upper_start[u + 1])
+    vector<ui> upper_start;
+    vector<uint64_t> edge_state;
+    vector<uint64_t> core_bits;
+    vector<uint64_t> non_core_bits;
+    CompactDisjointSets disjoint_sets;
+
+    CompactLayout(ui n, vector<ui> &&upper_start) :
+            upper_start(std::move(upper_start)), edge_state((this->upper_start[n] + 31) / 32, 0),
+            core_bits((n + 63) / 64, 0), non_core_bits((n + 63) / 64, 0), disjoint_sets(n) {}
+
+    uint64_t EdgeState(ui id) const {
+        return (__atomic_load_n(&edge_state[id >> 5], __ATOMIC_ACQUIRE) >> ((id & 31) << 1)) & 3u;
+    }
+
+    bool ClaimEdge(ui id) {
+        auto shift = (id & 31) << 1;
+        auto word = __atomic_load_n(&edge_state[id >> 5], __ATOMIC_RELAXED);
+        // neighboring states in the same word may change meanwhile, retry as long as this one is unknown
+        while (((word >> shift) & 3u) == EDGE_UNKNOWN) {
+            if (__atomic_compare_exchange_n(&edge_state[id >> 5], &word, word | (EDGE_IN_PROGRESS << shift), true,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // IN_PROGRESS (0b11) -> SIMILAR (0b01) or NOT_SIMILAR (0b10)
+    void PublishEdge(ui id, uint64_t state) {
+        __atomic_fetch_xor(&edge_state[id >> 5], (EDGE_IN_PROGRESS ^ state) << ((id & 31) << 1), __ATOMIC_RELEASE);
+    }
+
+    bool IsCore(int u) const {
+        return (__atomic_load_n(&core_bits[u >> 6], __ATOMIC_RELAXED) >> (u & 63)) & 1u;
+    }
+
+    bool IsNonCore(int u) const {
+        return (__atomic_load_n(&non_core_bits[u >> 6], __ATOMIC_RELAXED) >> (u & 63)) & 1u;
+    }
+
+    void SetCore(int u) {
+        __atomic_fetch_or(&core_bits[u >> 6], uint64_t(1) << (u & 63), __ATOMIC_RELAXED);
+    }
+
+    void SetNonCore(int u) {
+        __atomic_fetch_or(&non_core_bits[u >> 6], uint64_t(1) << (u & 63), __ATOMIC_RELAXED);
+    }
+
+    size_t Bytes() const {
+        return upper_start.size() * sizeof(ui) + edge_state.size() * sizeof(uint64_t) +
+               (core_bits.size() + non_core_bits.size()) * sizeof(uint64_t) +
+               disjoint_sets.size() * sizeof(uint32_t);
+    }
+};
+
+#endif //PPSCAN_COMPACT_LAYOUT_H
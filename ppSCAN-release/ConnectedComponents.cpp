@@ -0,0 +1,130 @@
+#include "Graph.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+constexpr int AFFOREST_NEIGHBOR_ROUNDS = 2;
+constexpr int AFFOREST_SAMPLE_NUM = 1024;
+
+namespace {
+    // the loop of the clustering phases, Sets either concrete or the ConcurrentUnionFind interface
+    template<typename Sets>
+    void LinkEdges(size_t thread_num, const vector<pair<uint32_t, uint32_t>> &edges, Sets &sets) {
+        ParallelForStatic(thread_num, static_cast<ui>(edges.size()), [&sets, &edges](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) {
+                if (!sets.IsSameSet(edges[i].first, edges[i].second)) { sets.Union(edges[i].first, edges[i].second); }
+            }
+        });
+    }
+}
+
+bool Graph::IsKnownSimilarCoreEdge(ui edge_idx) {
+    return min_cn[edge_idx] == SIMILAR && IsDefiniteCoreVertex(out_edges[edge_idx]);
+}
+
+// over the full adjacency lists also in core subgraph mode: its core-core edges are one direction only, while the
+// last step links an edge from whichever endpoint is outside the largest component
+void Graph::AfforestLink(ConcurrentUnionFind &sets) {
+    auto core_num = static_cast<ui>(cores.size());
+    auto thread_num = profile.schedule.thread_num;
+    // 1st: the first known-similar core neighbors of every core, one round at a time
+    for (auto round = 0; round < AFFOREST_NEIGHBOR_ROUNDS; round++) {
+        ParallelForStatic(thread_num, core_num, [this, &sets, round](ui i_start, ui i_end) {
+            for (auto i = i_start; i < i_end; i++) {
+                auto u = cores[i];
+                auto rank = 0;
+                for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                    if (IsKnownSimilarCoreEdge(edge_idx) && rank++ == round) {
+                        sets.Union(static_cast<uint32_t>(u), static_cast<uint32_t>(out_edges[edge_idx]));
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    if (core_num == 0) { return; }
+
+    // 2nd: the most frequent root of a sample is very likely the largest component
+    mt19937 gen(static_cast<unsigned>(core_num));
+    uniform_int_distribution<ui> distribution(0, core_num - 1);
+    unordered_map<uint32_t, int> root_count;
+    for (auto s = 0; s < AFFOREST_SAMPLE_NUM; s++) {
+        ++root_count[sets.FindRoot(static_cast<uint32_t>(cores[distribution(gen)]))];
+    }
+    auto frequent_root = max_element(root_count.begin(), root_count.end(),
+                                     [](const pair<const uint32_t, int> &l, const pair<const uint32_t, int> &r) {
+                                         return l.second < r.second;
+                                     })->first;
+
+    // 3rd: the remaining edges, both directions; an edge between the largest component and another one is
+    // linked from the side outside of it
+    ParallelForStatic(thread_num, core_num, [this, &sets, frequent_root](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            if (sets.FindRoot(static_cast<uint32_t>(u)) == frequent_root) { continue; }
+            auto rank = 0;
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (IsKnownSimilarCoreEdge(edge_idx) && rank++ >= AFFOREST_NEIGHBOR_ROUNDS) {
+                    sets.Union(static_cast<uint32_t>(u), static_cast<uint32_t>(out_edges[edge_idx]));
+                }
+            }
+        }
+    });
+}
+
+void Graph::BenchmarkCCEngines() {
+    // the core-core edges known similar at the end of the run: their components are the core clusters
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (auto u: cores) {
+        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+            if (u < out_edges[edge_idx] && IsKnownSimilarCoreEdge(edge_idx)) {
+                edges.emplace_back(u, out_edges[edge_idx]);
+            }
+        }
+    }
+    cout << "cc benchmark, cores:" << cores.size() << ", known-similar core-core edges:" << edges.size() << "\n";
+
+    // same partition of the cores as the clustering of the run: each root is in the other's set
+    auto report = [this](const char *name, double time, const ConcurrentUnionFind &sets) {
+        auto agree_num = ParallelReduce(profile.schedule.thread_num, static_cast<ui>(cores.size()), 0l,
+                                        [this, &sets](ui i_start, ui i_end) {
+                                            auto local_num = 0l;
+                                            for (auto i = i_start; i < i_end; i++) {
+                                                auto u = static_cast<uint32_t>(cores[i]);
+                                                if (sets.IsSameSet(u, disjoint_set_ptr->FindRoot(u)) &&
+                                                    disjoint_set_ptr->IsSameSet(u, sets.FindRoot(u))) {
+                                                    ++local_num;
+                                                }
+                                            }
+                                            return local_num;
+                                        });
+        cout << "cc engine:" << name << ", time:" << time * 1000 << " ms, bytes per vertex:"
+             << sets.BytesPerElement() << ", cores agreeing with the run:" << agree_num << "/" << cores.size()
+             << "\n";
+    };
+
+    // every engine through the interface
+    for (auto engine: {CCEngine::WJAKOB, CCEngine::LINK_BY_INDEX, CCEngine::REM, CCEngine::AFFOREST}) {
+        auto sets = NewUnionFind(engine, n);
+        auto start = high_resolution_clock::now();
+        if (engine == CCEngine::AFFOREST) {
+            AfforestLink(*sets);
+        } else {
+            LinkEdges(profile.schedule.thread_num, edges, *sets);
+        }
+        report(CCEngineName(engine), duration<double>(high_resolution_clock::now() - start).count(), *sets);
+    }
+
+    // the default engine as the clustering phases call it, concrete DisjointSets without the indirect call
+    CoreUnionFind default_sets(DEFAULT_CC_ENGINE, n);
+    auto start = high_resolution_clock::now();
+    LinkEdges(profile.schedule.thread_num, edges, default_sets);
+    report("wjakob (direct, as in the run)", duration<double>(high_resolution_clock::now() - start).count(),
+           default_sets);
+}
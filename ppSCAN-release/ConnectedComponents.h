@@ -0,0 +1,194 @@
+#ifndef PPSCAN_CONNECTED_COMPONENTS_H
+#define PPSCAN_CONNECTED_COMPONENTS_H
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include "ThreadSafeDisjointSet.h"
+
+using namespace std;
+
+/*
+ * connected-components engines of core clustering, all concurrent union-find structures:
+ * WJAKOB:        DisjointSets, 8 bytes per vertex, union by rank
+ * LINK_BY_INDEX: CompactDisjointSets, 4 bytes per vertex, larger root linked under the smaller one (as in SCAN_XP)
+ * REM:           Rem's algorithm with splicing, 4 bytes per vertex
+ * AFFOREST:      REM's structure, the known-similar core edges are linked Afforest-style (sampled neighbor
+ *                rounds, then all remaining edges except those of the largest component), see Graph::AfforestLink
+ */
+enum class CCEngine : int {
+    WJAKOB = 0, LINK_BY_INDEX = 1, REM = 2, AFFOREST = 3
+};
+
+constexpr CCEngine DEFAULT_CC_ENGINE = CCEngine::WJAKOB;
+
+inline const char *CCEngineName(CCEngine engine) {
+    switch (engine) {
+        case CCEngine::LINK_BY_INDEX:
+            return "link-by-index";
+        case CCEngine::REM:
+            return "rem";
+        case CCEngine::AFFOREST:
+            return "afforest";
+        default:
+            return "wjakob";
+    }
+}
+
+inline CCEngine ParseCCEngine(const char *name) {
+    for (auto engine: {CCEngine::LINK_BY_INDEX, CCEngine::REM, CCEngine::AFFOREST}) {
+        if (strcmp(name, CCEngineName(engine)) == 0) { return engine; }
+    }
+    return CCEngine::WJAKOB;
+}
+
+class ConcurrentUnionFind {
+public:
+    virtual ~ConcurrentUnionFind() = default;
+
+    virtual uint32_t FindRoot(uint32_t id) const = 0;
+
+    virtual bool IsSameSet(uint32_t id1, uint32_t id2) const = 0;
+
+    virtual uint32_t Union(uint32_t id1, uint32_t id2) = 0;
+
+    virtual uint32_t size() const = 0;
+
+    virtual size_t BytesPerElement() const = 0;
+};
+
+template<typename T>
+class UnionFindAdapter : public ConcurrentUnionFind {
+    T sets_;
+    size_t bytes_per_element_;
+
+public:
+    UnionFindAdapter(uint32_t size, size_t bytes_per_element) : sets_(size), bytes_per_element_(bytes_per_element) {}
+
+    uint32_t FindRoot(uint32_t id) const override { return sets_.FindRoot(id); }
+
+    bool IsSameSet(uint32_t id1, uint32_t id2) const override { return sets_.IsSameSet(id1, id2); }
+
+    uint32_t Union(uint32_t id1, uint32_t id2) override { return sets_.Union(id1, id2); }
+
+    uint32_t size() const override { return sets_.size(); }
+
+    size_t BytesPerElement() const override { return bytes_per_element_; }
+};
+
+/**
+ * Rem's union-find with splicing, lock-free: parents only ever decrease (parent[i] <= i), a root is linked by CAS,
+ * and on the way up the parent of the side with the larger parent is spliced onto the smaller parent,
+ * so the root of a set is its minimum element
+ */
+class RemSplicingSets : public ConcurrentUnionFind {
+public:
+    explicit RemSplicingSets(uint32_t size) : data_size(size), mParent(new std::atomic<uint32_t>[size]) {
+        for (uint32_t i = 0; i < size; ++i)
+            mParent[i] = i;
+    }
+
+    uint32_t FindRoot(uint32_t id) const override {
+        for (;;) {
+            uint32_t parent = mParent[id].load(std::memory_order_relaxed);
+            if (parent == id)
+                return id;
+            uint32_t grand_parent = mParent[parent].load(std::memory_order_relaxed);
+            if (parent != grand_parent)
+                mParent[id].compare_exchange_weak(parent, grand_parent);
+            id = grand_parent;
+        }
+    }
+
+    bool IsSameSet(uint32_t id1, uint32_t id2) const override {
+        for (;;) {
+            id1 = FindRoot(id1);
+            id2 = FindRoot(id2);
+            if (id1 == id2)
+                return true;
+            if (mParent[id1].load() == id1)
+                return false;
+        }
+    }
+
+    uint32_t Union(uint32_t id1, uint32_t id2) override {
+        for (;;) {
+            uint32_t parent1 = mParent[id1].load(), parent2 = mParent[id2].load();
+            if (parent1 == parent2)
+                return parent1;
+            if (parent1 < parent2) {
+                std::swap(id1, id2);
+                std::swap(parent1, parent2);
+            }
+            if (id1 == parent1) {
+                /* id1 is a root: link it under the smaller parent */
+                if (mParent[id1].compare_exchange_strong(parent1, parent2))
+                    return parent2;
+                continue;
+            }
+            /* Splice (may fail, that's ok): id1's subtree moves under parent2, then continue from the old parent */
+            mParent[id1].compare_exchange_weak(parent1, parent2);
+            id1 = parent1;
+        }
+    }
+
+    uint32_t size() const override { return data_size; }
+
+    size_t BytesPerElement() const override { return sizeof(uint32_t); }
+
+    uint32_t data_size;
+    std::unique_ptr<std::atomic<uint32_t>[]> mParent;   // owned, the sets are move-only
+};
+
+inline unique_ptr<ConcurrentUnionFind> NewUnionFind(CCEngine engine, uint32_t size) {
+    switch (engine) {
+        case CCEngine::LINK_BY_INDEX:
+            return unique_ptr<ConcurrentUnionFind>(
+                    new UnionFindAdapter<CompactDisjointSets>(size, sizeof(uint32_t)));
+        case CCEngine::REM:
+        case CCEngine::AFFOREST:
+            return unique_ptr<ConcurrentUnionFind>(new RemSplicingSets(size));
+        default:
+            return unique_ptr<ConcurrentUnionFind>(new UnionFindAdapter<DisjointSets>(size, sizeof(uint64_t)));
+    }
+}
+
+/**
+ * the sets of core clustering: the default engine keeps a concrete DisjointSets, called without the indirect call of
+ * the interface, the other engines go through it; final, so calls on this type are not virtual either. Each call
+ * still tests which one is set: one branch, taken the same way for the whole run, so predicted
+ */
+class CoreUnionFind final : public ConcurrentUnionFind {
+    unique_ptr<DisjointSets> default_sets_;
+    unique_ptr<ConcurrentUnionFind> engine_sets_;
+
+public:
+    CoreUnionFind(CCEngine engine, uint32_t size) {
+        if (engine == DEFAULT_CC_ENGINE) {
+            default_sets_ = unique_ptr<DisjointSets>(new DisjointSets(size));
+        } else {
+            engine_sets_ = NewUnionFind(engine, size);
+        }
+    }
+
+    uint32_t FindRoot(uint32_t id) const override {
+        return default_sets_ != nullptr ? default_sets_->FindRoot(id) : engine_sets_->FindRoot(id);
+    }
+
+    bool IsSameSet(uint32_t id1, uint32_t id2) const override {
+        return default_sets_ != nullptr ? default_sets_->IsSameSet(id1, id2) : engine_sets_->IsSameSet(id1, id2);
+    }
+
+    uint32_t Union(uint32_t id1, uint32_t id2) override {
+        return default_sets_ != nullptr ? default_sets_->Union(id1, id2) : engine_sets_->Union(id1, id2);
+    }
+
+    uint32_t size() const override { return default_sets_ != nullptr ? default_sets_->size() : engine_sets_->size(); }
+
+    size_t BytesPerElement() const override {
+        return default_sets_ != nullptr ? sizeof(uint64_t) : engine_sets_->BytesPerElement();
+    }
+};
+
+#endif //PPSCAN_CONNECTED_COMPONENTS_H
@@ -0,0 +1,106 @@
+#include "Graph.h"
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+void Graph::ExtractCoreSubgraph() {
+    auto start = high_resolution_clock::now();
+    auto core_num = static_cast<ui>(cores.size());
+    core_subgraph_ptr = yche::make_unique<CoreSubgraph>();
+    auto &subgraph = *core_subgraph_ptr;
+    subgraph.core_core_start.assign(core_num + 1, 0);
+    subgraph.core_non_core_start.assign(core_num + 1, 0);
+
+    // count, prefix sum, fill: both lists keep the adjacency order of each core
+    ParallelForStatic(profile.schedule.thread_num, core_num, [this, &subgraph](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto v = out_edges[edge_idx];
+                if (min_cn[edge_idx] == NOT_SIMILAR) { continue; }
+                if (!IsDefiniteCoreVertex(v)) {
+                    ++subgraph.core_non_core_start[i];
+                } else if (u < v) {
+                    ++subgraph.core_core_start[i];
+                }
+            }
+        }
+    });
+    ParallelExclusiveScan(profile.schedule.thread_num, subgraph.core_core_start);
+    ParallelExclusiveScan(profile.schedule.thread_num, subgraph.core_non_core_start);
+    subgraph.core_core_edges.resize(subgraph.core_core_start[core_num]);
+    subgraph.core_non_core_edges.resize(subgraph.core_non_core_start[core_num]);
+    ParallelForStatic(profile.schedule.thread_num, core_num, [this, &subgraph](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            auto core_core_pos = subgraph.core_core_start[i];
+            auto non_core_pos = subgraph.core_non_core_start[i];
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto v = out_edges[edge_idx];
+                if (min_cn[edge_idx] == NOT_SIMILAR) { continue; }
+                if (!IsDefiniteCoreVertex(v)) {
+                    subgraph.core_non_core_edges[non_core_pos++] = {v, edge_idx};
+                } else if (u < v) {
+                    subgraph.core_core_edges[core_core_pos++] = {v, edge_idx};
+                }
+            }
+        }
+    });
+    auto end = high_resolution_clock::now();
+    auto core_entry_num = ParallelReduce(profile.schedule.thread_num, core_num, 0l, [this](ui i_start, ui i_end) {
+        auto local_num = 0l;
+        for (auto i = i_start; i < i_end; i++) { local_num += Degree(cores[i]) - 1; }
+        return local_num;
+    });
+    cout << "3rd: core subgraph, core-core edges:" << subgraph.core_core_edges.size() << ", core-non-core edges:"
+         << subgraph.core_non_core_edges.size() << ", adjacency entries of cores:" << core_entry_num
+         << ", extraction time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
+}
+
+long Graph::EstimateCompactedClusterCost(ui i, bool is_core_core) {
+    auto &subgraph = *core_subgraph_ptr;
+    auto &start = is_core_core ? subgraph.core_core_start : subgraph.core_non_core_start;
+    auto &edges = is_core_core ? subgraph.core_core_edges : subgraph.core_non_core_edges;
+    auto u = cores[i];
+    long cost = start[i + 1] - start[i];
+    for (auto j = start[i]; j < start[i + 1]; j++) {
+        if (min_cn[edges[j].edge_idx] > 0) { cost += Degree(u) + Degree(edges[j].v); }
+    }
+    return cost;
+}
+
+void Graph::ClusterCoreFirstPhaseCompacted(ui i) {
+    auto &subgraph = *core_subgraph_ptr;
+    auto u = static_cast<uint32_t>(cores[i]);
+    for (auto j = subgraph.core_core_start[i]; j < subgraph.core_core_start[i + 1]; j++) {
+        auto &edge = subgraph.core_core_edges[j];
+        if (min_cn[edge.edge_idx] == SIMILAR && !disjoint_set_ptr->IsSameSet(u, static_cast<uint32_t>(edge.v))) {
+            disjoint_set_ptr->Union(u, static_cast<uint32_t>(edge.v));
+        }
+    }
+}
+
+void Graph::ClusterCoreSecondPhaseCompacted(ui i) {
+    auto &subgraph = *core_subgraph_ptr;
+    thread_local vector<ui> candidates;
+    candidates.clear();
+    for (auto j = subgraph.core_core_start[i]; j < subgraph.core_core_start[i + 1]; j++) {
+        auto edge_idx = subgraph.core_core_edges[j].edge_idx;
+        if (min_cn[edge_idx] > 0) { candidates.emplace_back(edge_idx); }
+    }
+    ClusterCoreCandidates(cores[i], candidates);
+}
+
+void Graph::ClusterNonCoreCompacted(ui i, NonCoreWriter &writer) {
+    auto &subgraph = *core_subgraph_ptr;
+    thread_local vector<ui> candidates;
+    ReserveScratch(candidates);
+    candidates.clear();
+    for (auto j = subgraph.core_non_core_start[i]; j < subgraph.core_non_core_start[i + 1]; j++) {
+        candidates.emplace_back(subgraph.core_non_core_edges[j].edge_idx);
+    }
+    ClusterNonCoreCandidates(cores[i], candidates, writer);
+}
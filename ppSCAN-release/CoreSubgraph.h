@@ -0,0 +1,28 @@
+#ifndef PPSCAN_CORE_SUBGRAPH_H
+#define PPSCAN_CORE_SUBGRAPH_H
+
+#include <vector>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * core subgraph mode: after check-core, the edges the clustering phases still touch, extracted per core into
+ * dense arrays, instead of scanning the full adjacency lists and skipping on scattered core status loads
+ */
+struct CoreEdge {
+    int v;
+    ui edge_idx;    // copy of the edge in the core's adjacency, its min_cn state is the one carried over
+};
+
+class CoreSubgraph {
+public:
+    // core i = cores[i]: core-core edges (v > cores[i], not known dissimilar)
+    vector<ui> core_core_start;
+    vector<CoreEdge> core_core_edges;
+    // core i: core to non-core edges (not known dissimilar)
+    vector<ui> core_non_core_start;
+    vector<CoreEdge> core_non_core_edges;
+};
+
+#endif //PPSCAN_CORE_SUBGRAPH_H
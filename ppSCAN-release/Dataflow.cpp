@@ -0,0 +1,150 @@
+#include "Graph.h"
+
+#include <mutex>
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+bool Graph::IsAttachedAtSettle(int v) {
+    return !is_pruned_non_core.empty() && is_pruned_non_core[v];
+}
+
+long Graph::EstimateSettleCost(int u) {
+    if (!IsDefiniteCoreVertex(u) || is_settled[u]) { return 0; }
+    long cost = Degree(u);
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (min_cn[edge_idx] > 0 && (IsDefiniteCoreVertex(v) || IsAttachedAtSettle(v))) {
+            cost += Degree(u) + Degree(v);
+        }
+    }
+    return cost;
+}
+
+void Graph::SettleCore(int u, vector<pair<int, int>> &attachments) {
+    is_settled[u] = true;
+    // the core status store of u happens before the loads below, and symmetrically for v,
+    // so of two cores settling concurrently at least one sees the other: no core-core edge is missed
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (__atomic_load_n(&core_status_lst[v], __ATOMIC_RELAXED) == CORE) {
+            if (disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u), static_cast<uint32_t>(v))) { continue; }
+            if (ComputeSimilarityOnce(u, edge_idx, true) == SIMILAR) {
+                log_info("settle union u: %d, v:%d", u, v);
+                disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+            }
+        } else if (IsAttachedAtSettle(v)) {
+            if (ComputeSimilarityOnce(u, edge_idx, true) == SIMILAR) { attachments.emplace_back(u, v); }
+        }
+    }
+}
+
+void Graph::pSCANDataflowCheckCore() {
+    is_settled = vector<char>(n, false);
+    is_pruned_non_core = vector<char>(n, false);
+    ParallelForStatic(profile.schedule.thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) { is_pruned_non_core[u] = core_status_lst[u] == NON_CORE; }
+    });
+
+    // a core settles in the task that decides it, or in the first task visiting it afterwards
+    mutex attachments_mutex;
+    auto settle_in_task = [this, &attachments_mutex](ui i_start, ui i_end, bool is_first_bsp) {
+        vector<pair<int, int>> local_attachments;
+        auto mirror_writer = NewMirrorWriter();
+        for (auto u = i_start; u < i_end; u++) {
+            if (is_first_bsp) {
+                CheckCoreFirstBSP(u, mirror_writer.get());
+            } else {
+                CheckCoreSecondBSP(u, mirror_writer.get());
+            }
+            if (IsDefiniteCoreVertex(u) && !is_settled[u]) { SettleCore(u, local_attachments); }
+        }
+        lock_guard<mutex> lock(attachments_mutex);
+        settled_attachments.insert(settled_attachments.end(), local_attachments.begin(), local_attachments.end());
+    };
+
+    auto find_core_start = high_resolution_clock::now();
+    if (is_owner_computes) {
+        mirror_partitions_ptr = yche::make_unique<MirrorPartitions>(n, out_edge_start,
+                                                                   static_cast<ui>(profile.schedule.thread_num));
+    }
+    ProcessHubs(HubPhase::CHECK_CORE_FIRST_BSP);
+    ExecuteLongestFirst("2nd: dataflow check core first-phase bsp", profile.schedule, n, [this](ui u) -> long {
+        return EstimateCheckCoreCost(u, true) + EstimateSettleCost(u);
+    }, [&settle_in_task](ui i_start, ui i_end) { settle_in_task(i_start, i_end, true); });
+    ApplyMirrorUpdates("2nd: apply first-phase mirror updates");
+    auto first_bsp_end = high_resolution_clock::now();
+    cout << "2nd: dataflow check core first-phase bsp time:"
+         << duration_cast<milliseconds>(first_bsp_end - find_core_start).count() << " ms\n";
+
+    ProcessHubs(HubPhase::CHECK_CORE_SECOND_BSP);
+    ExecuteLongestFirst("2nd: dataflow check core second-phase bsp", profile.schedule, n, [this](ui u) -> long {
+        return EstimateCheckCoreCost(u, false) + EstimateSettleCost(u);
+    }, [&settle_in_task](ui i_start, ui i_end) { settle_in_task(i_start, i_end, false); });
+    ApplyMirrorUpdates("2nd: apply second-phase mirror updates");
+    mirror_partitions_ptr.reset();
+    auto second_bsp_end = high_resolution_clock::now();
+    cout << "2nd: dataflow check core second-phase bsp time:"
+         << duration_cast<milliseconds>(second_bsp_end - first_bsp_end).count() << " ms\n";
+
+    // cores decided by the resolutions of their neighbors, after their own task
+    ExecuteLongestFirst("2nd: dataflow settle remaining", profile.schedule, n, [this](ui u) -> long {
+        return EstimateSettleCost(u);
+    }, [this, &attachments_mutex](ui i_start, ui i_end) {
+        vector<pair<int, int>> local_attachments;
+        for (auto u = i_start; u < i_end; u++) {
+            if (IsDefiniteCoreVertex(u) && !is_settled[u]) { SettleCore(u, local_attachments); }
+        }
+        lock_guard<mutex> lock(attachments_mutex);
+        settled_attachments.insert(settled_attachments.end(), local_attachments.begin(), local_attachments.end());
+    });
+}
+
+void Graph::pSCANDataflowClusterNonCore() {
+    auto tmp_start = high_resolution_clock::now();
+    ParallelSelect(profile.schedule.thread_num, n, [this](ui u) { return IsDefiniteCoreVertex(u); }, cores);
+    cout << "core size:" << cores.size() << ", attached at settle:" << settled_attachments.size() << "\n";
+
+    // the core clusters are complete once every core has settled
+    noncore_cluster = std::vector<pair<int, int>>(settled_attachments.size());
+    MarkClusterMinEleAsId();
+    ParallelForStatic(profile.schedule.thread_num, static_cast<ui>(settled_attachments.size()),
+                      [this](ui i_start, ui i_end) {
+                          for (auto i = i_start; i < i_end; i++) {
+                              auto &attachment = settled_attachments[i];
+                              noncore_cluster[i] = make_pair(cluster_dict[disjoint_set_ptr->FindRoot(
+                                      static_cast<uint32_t>(attachment.first))], attachment.second);
+                          }
+                      });
+    vector<pair<int, int>>().swap(settled_attachments);
+
+    // the remaining non-cores: decided during check-core
+    CollectNonCoreClusters("4th: dataflow cluster non-core", NonCorePairBound(), [this](ui i) -> long {
+        return EstimateClusterCost(cores[i], false);
+    }, [this](ui i, NonCoreWriter &writer) {
+        ClusterNonCoreDetail(cores[i], writer);
+    });
+
+    auto all_end = high_resolution_clock::now();
+    cout << "4th: dataflow non-core clustering time:" << duration_cast<milliseconds>(all_end - tmp_start).count()
+         << " ms\n";
+}
+
+void Graph::pSCANDataflow() {
+    cout << "new algorithm ppSCAN (dataflow), runtime:" << RuntimeName() << ", threads:"
+         << profile.schedule.thread_num << ", similarity:" << Similarity::NAME << endl;
+    pSCANFirstPhasePrune();
+    PrintMinCnBeauty();
+    auto undecided_after_prune = CountUndecidedEdges();
+
+    pSCANDataflowCheckCore();
+    PrintMinCnBeauty();
+
+    pSCANDataflowClusterNonCore();
+    PrintMinCnBeauty();
+    ReportSimilarityComputations(undecided_after_prune);
+}
@@ -14,24 +14,53 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
+#include <thread>
 
 #include "playground/pretty_print.h"
 
-#include "ThreadPool.h"
+#include "AllocationCounter.h"
+#include "TaskScheduler.h"
 #include "util/log/log.h"
 #include "util/util.h"
 
 using namespace std::chrono;
 using namespace yche;
 
-Graph::Graph(const char *dir_string, const char *eps_s, int min_u) {
+Graph::Graph(const char *dir_string, const char *eps_s, int min_u) : dir(dir_string) {
     io_helper_ptr = yche::make_unique<InputOutput>(dir_string);
     io_helper_ptr->ReadGraph();
 
     auto tmp_start = high_resolution_clock::now();
     // 1st: parameter
-    std::tie(eps_a2, eps_b2) = io_helper_ptr->ParseEps(eps_s);
+    int eps_a, eps_b;
+    std::tie(eps_a, eps_b) = io_helper_ptr->ParseEps(eps_s);
+    similarity = Similarity(eps_a, eps_b);
+    eps = static_cast<double>(eps_a) / eps_b;
     this->min_u = min_u;
+    similarity_computations = 0;
+    claim_conflicts = 0;
+    signature_pruned = 0;
+    min_hash_similar = 0;
+    min_hash_not_similar = 0;
+    candidate_order = CandidateOrder::ADJACENCY;
+    candidates_skipped = 0;
+    interleave_width = 1;
+    tile_cache_bytes = 0;
+    is_core_subgraph = false;
+    cc_engine = DEFAULT_CC_ENGINE;
+    same_set_skipped = 0;
+    is_owner_computes = false;
+    glue_select_cores_time = 0;
+    glue_init_cluster_dict_time = 0;
+    glue_non_core_output_time = 0;
+    glue_edge_ids_time = 0;
+    scratch_reserve = 0;
+    is_hub_selected = false;
+    alpha_block_size = DEFAULT_ALPHA_BLOCK_SIZE;
+    beta_block_size = DEFAULT_BETA_BLOCK_SIZE;
+    similarity_engine = SimilarityEngine::PIPELINE;
+    is_export_similarity = false;
 
     // 2nd: graph
     // csr representation
@@ -39,24 +68,21 @@ Graph::Graph(const char *dir_string, const char *eps_s, int min_u) {
     out_edge_start = std::move(io_helper_ptr->offset_out_edges);
     out_edges = std::move(io_helper_ptr->out_edges);
 
-    // vertex properties
-    degree = std::move(io_helper_ptr->degree);
-    core_status_lst = vector<char>(n, UN_KNOWN);
+    // vertex properties, the degree is derived from the offsets
+    vector<int>().swap(io_helper_ptr->degree);
+    similar_degree = static_cast<int *>(_mm_malloc(n * sizeof(int), 32));
+    effective_degree = static_cast<int *>(_mm_malloc(n * sizeof(int), 32));
 
-    // edge properties
-    min_cn = static_cast<int *>(_mm_malloc(io_helper_ptr->m * sizeof(int), 32));
-#define PTR_TO_UINT64(x) (uint64_t)(uintptr_t)(x)
-    assert(PTR_TO_UINT64(min_cn) % 32 == 0);
+    // 3rd: edge states, core status, disjoint-set and cluster_dict depend on the layout, allocated by the phases
+    min_cn = nullptr;
+    cluster_dict = nullptr;
 
-    // 3rd: disjoint-set, make-set at the beginning
-    disjoint_set_ptr = yche::make_unique<DisjointSets>(n);
-
-    // 4th: cluster_dict
-    cluster_dict = static_cast<int *>(_mm_malloc(io_helper_ptr->n * sizeof(int), 32));
-    for (auto i = 0; i < io_helper_ptr->n; i++) {
-        cluster_dict[i] = n;
+    // 5th: machine, graph and parameter specific tune profile, if any
+    if (LoadTuneProfile(dir, n, io_helper_ptr->m, eps, min_u, profile)) {
+        cout << "load tune profile " << TuneProfilePath(dir, eps, min_u) << ", kernel:" << KernelName(profile.kernel)
+             << ", threads:" << profile.schedule.thread_num << ", tasks per thread:"
+             << profile.schedule.tasks_per_thread << ", min task cost:" << profile.schedule.min_task_cost << "\n";
     }
-    assert(PTR_TO_UINT64(cluster_dict) % 32 == 0);
 
     auto all_end = high_resolution_clock::now();
     cout << "other construct time:" << duration_cast<milliseconds>(all_end - tmp_start).count()
@@ -64,18 +90,49 @@ Graph::Graph(const char *dir_string, const char *eps_s, int min_u) {
 }
 
 Graph::~Graph() {
+    _mm_free(similar_degree);
+    _mm_free(effective_degree);
     _mm_free(min_cn);
     _mm_free(cluster_dict);
 }
 
+void Graph::AllocateStandardLayout() {
+    if (min_cn != nullptr) { return; }
+    core_status_lst = vector<char>(n, UN_KNOWN);
+
+    // edge properties
+    min_cn = static_cast<int *>(_mm_malloc(out_edge_start[n] * sizeof(int), 32));
+#define PTR_TO_UINT64(x) (uint64_t)(uintptr_t)(x)
+    assert(PTR_TO_UINT64(min_cn) % 32 == 0);
+
+    // disjoint-set, make-set at the beginning
+    disjoint_set_ptr = yche::make_unique<CoreUnionFind>(cc_engine, n);
+
+    // cluster_dict
+    auto glue_start = high_resolution_clock::now();
+    cluster_dict = static_cast<int *>(_mm_malloc(n * sizeof(int), 32));
+    ParallelFill(profile.schedule.thread_num, cluster_dict, n, static_cast<int>(n));
+    assert(PTR_TO_UINT64(cluster_dict) % 32 == 0);
+    glue_init_cluster_dict_time += duration<double>(high_resolution_clock::now() - glue_start).count();
+}
+
 void Graph::Output(const char *eps_s, const char *miu) {
+    if (compact_ptr != nullptr) {
+        io_helper_ptr->Output(eps_s, miu, noncore_cluster, compact_ptr->core_bits, compact_ptr->disjoint_sets);
+        return;
+    }
     io_helper_ptr->Output(eps_s, miu, noncore_cluster, core_status_lst, cluster_dict, *disjoint_set_ptr);
 }
 
-int Graph::ComputeCnLowerBound(int du, int dv) {
-    auto c = (int) (sqrtl((((long double) du) * ((long double) dv) * eps_a2) / eps_b2));
-    if (((long long) c) * ((long long) c) * eps_b2 < ((long long) du) * ((long long) dv) * eps_a2) { ++c; }
-    return c;
+int Graph::PruneState(int u, ui edge_idx) {
+    if (!edge_weights.empty()) { return WeightedPruneState(u, edge_idx); }
+    auto v = out_edges[edge_idx];
+    int deg_a = Degree(u), deg_b = Degree(v);
+    if (deg_a > deg_b) { swap(deg_a, deg_b); }
+    if (similarity.IsDegreePruned(deg_a, deg_b)) { return NOT_SIMILAR; }
+    // u and v are in both closed neighborhoods
+    int c = similarity.MinCn(deg_a, deg_b);
+    return c <= 2 ? SIMILAR : c;
 }
 
 bool Graph::IsDefiniteCoreVertex(int u) {
@@ -88,7 +145,194 @@ ui Graph::BinarySearch(EdgeVec &array, ui offset_beg, ui offset_end, int val) {
     return val < array[mid] ? BinarySearch(array, offset_beg, mid, val) : BinarySearch(array, mid + 1, offset_end, val);
 }
 
+void Graph::UpdateDegree(int u, int result) {
+    // sd <= ed always holds, so each vertex crosses at most one threshold, exactly once
+    if (result == SIMILAR) {
+        if (__sync_add_and_fetch(&similar_degree[u], 1) == min_u) {
+            log_info("finalize (CORE), u:%d", u);
+            core_status_lst[u] = CORE;
+        }
+    } else {
+        if (__sync_sub_and_fetch(&effective_degree[u], 1) == min_u - 1) {
+            log_info("finalize (NON-CORE), u:%d", u);
+            core_status_lst[u] = NON_CORE;
+        }
+    }
+}
+
+void Graph::ResolveEdge(int u, ui edge_idx, int result) {
+    auto v = out_edges[edge_idx];
+    auto reverse_edge_idx = BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u);
+    // the edge stored at the smaller endpoint decides which resolution wins
+    auto owner_edge_idx = u < v ? edge_idx : reverse_edge_idx;
+    auto min_cn_num = min_cn[owner_edge_idx];
+    if (min_cn_num <= 0 || !__sync_bool_compare_and_swap(&min_cn[owner_edge_idx], min_cn_num, result)) { return; }
+    __sync_fetch_and_add(&similarity_computations, 1);
+    min_cn[u < v ? reverse_edge_idx : edge_idx] = result;
+    UpdateDegree(u, result);
+    UpdateDegree(v, result);
+}
+
+int Graph::ClaimEdge(int u, ui edge_idx, bool is_wait, ui &reverse_edge_idx) {
+    // published results never change
+    if (min_cn[edge_idx] < 0) { return min_cn[edge_idx]; }
+
+    auto v = out_edges[edge_idx];
+    reverse_edge_idx = BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u);
+    auto owner_edge_idx = u < v ? edge_idx : reverse_edge_idx;
+    auto is_conflict = false;
+    while (true) {
+        // owner copy: threshold -> IN_PROGRESS (claimed) -> result (published)
+        auto min_cn_num = __atomic_load_n(&min_cn[owner_edge_idx], __ATOMIC_ACQUIRE);
+        if (min_cn_num < 0) { return min_cn_num; }
+        if (min_cn_num == IN_PROGRESS) {
+            if (!is_conflict) {
+                is_conflict = true;
+                __sync_fetch_and_add(&claim_conflicts, 1);
+            }
+            if (!is_wait) { return IN_PROGRESS; }
+            continue;
+        }
+        if (__sync_bool_compare_and_swap(&min_cn[owner_edge_idx], min_cn_num, IN_PROGRESS)) { return min_cn_num; }
+    }
+}
+
+void Graph::PublishClaimedEdge(int u, ui edge_idx, ui reverse_edge_idx, int result, MirrorWriter *mirror_writer) {
+    auto v = out_edges[edge_idx];
+    auto owner_edge_idx = u < v ? edge_idx : reverse_edge_idx;
+    __sync_fetch_and_add(&similarity_computations, 1);
+    if (mirror_writer != nullptr) {
+        // only the copy and the counters of u are written here, v's side is deferred to its partition
+        min_cn[edge_idx] = result;
+        __atomic_store_n(&min_cn[owner_edge_idx], result, __ATOMIC_RELEASE);
+        UpdateDegree(u, result);
+        mirror_writer->Push(v, reverse_edge_idx, result);
+        return;
+    }
+    min_cn[u < v ? reverse_edge_idx : edge_idx] = result;
+    __atomic_store_n(&min_cn[owner_edge_idx], result, __ATOMIC_RELEASE);
+    UpdateDegree(u, result);
+    UpdateDegree(v, result);
+}
+
+int Graph::ComputeSimilarityOnce(int u, ui edge_idx, bool is_wait, MirrorWriter *mirror_writer) {
+    ui reverse_edge_idx;
+    auto min_cn_num = ClaimEdge(u, edge_idx, is_wait, reverse_edge_idx);
+    if (min_cn_num <= 0) { return min_cn_num; }
+    auto result = EvalSimilarity(u, edge_idx, min_cn_num);
+    PublishClaimedEdge(u, edge_idx, reverse_edge_idx, result, mirror_writer);
+    return result;
+}
+
+void Graph::SetOwnerComputes(bool is_owner_computes) {
+    this->is_owner_computes = is_owner_computes;
+}
+
+void Graph::SetBusyReport(bool is_busy_report) {
+    profile.schedule.is_report = is_busy_report;
+}
+
+void Graph::SetCandidateOrder(CandidateOrder order) {
+    candidate_order = order;
+}
+
+void Graph::SetInterleaveWidth(ui width) {
+    interleave_width = min(max(width, 1u), MAX_INTERLEAVE_WIDTH);
+}
+
+void Graph::SetTileCacheBytes(size_t cache_bytes) {
+    tile_cache_bytes = cache_bytes;
+}
+
+void Graph::SetCoreSubgraph(bool is_core_subgraph) {
+    this->is_core_subgraph = is_core_subgraph;
+}
+
+void Graph::SetCCEngine(CCEngine engine) {
+    if (engine == cc_engine) { return; }
+    cc_engine = engine;
+    // make-set again, before any union
+    disjoint_set_ptr = yche::make_unique<CoreUnionFind>(cc_engine, n);
+}
+
+void Graph::SetSignatureBuckets(ui bucket_num) {
+    auto start = high_resolution_clock::now();
+    signatures_ptr = yche::make_unique<BucketSignatures>(n, bucket_num);
+    ParallelForStatic(profile.schedule.thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            auto row = signatures_ptr->Row(u);
+            signatures_ptr->Add(row, u);
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                signatures_ptr->Add(row, out_edges[edge_idx]);
+            }
+        }
+    });
+    auto end = high_resolution_clock::now();
+    cout << "signature buckets:" << signatures_ptr->bucket_num << ", construct time:"
+         << duration_cast<milliseconds>(end - start).count() << " ms\n";
+}
+
+unique_ptr<MirrorWriter> Graph::NewMirrorWriter() {
+    return mirror_partitions_ptr == nullptr ? nullptr : yche::make_unique<MirrorWriter>(*mirror_partitions_ptr);
+}
+
+void Graph::ApplyMirrorUpdates(const char *phase_name) {
+    if (mirror_partitions_ptr == nullptr) { return; }
+    auto &partitions = *mirror_partitions_ptr;
+    auto update_num = accumulate(partitions.region_size.begin(), partitions.region_size.end(), 0l);
+    ExecuteLongestFirst(phase_name, profile.schedule, partitions.partition_num, [&partitions](ui p) -> long {
+        return partitions.region_size[p];
+    }, [this, &partitions](ui p_start, ui p_end) {
+        for (auto p = p_start; p < p_end; p++) {
+            auto region = &partitions.updates[partitions.region_beg[p]];
+            for (auto i = 0u; i < partitions.region_size[p]; i++) {
+                min_cn[region[i].edge_idx] = region[i].result;
+                UpdateDegree(region[i].v, region[i].result);
+            }
+            partitions.region_size[p] = 0;
+        }
+    });
+    cout << phase_name << ": mirror updates:" << update_num << "\n";
+}
+
+long Graph::CountUndecidedEdges() {
+    return ParallelReduce(profile.schedule.thread_num, n, 0l, [this](ui i_start, ui i_end) {
+        auto undecided_num = 0l;
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (static_cast<int>(u) < out_edges[edge_idx] && min_cn[edge_idx] > 0) { ++undecided_num; }
+            }
+        }
+        return undecided_num;
+    });
+}
+
+void Graph::ReportSimilarityComputations(long undecided_after_prune) {
+    // every computed edge left the undecided state exactly once, so duplicates are computations beyond that
+    auto computed_edges = undecided_after_prune - CountUndecidedEdges();
+    cout << "similarity computations:" << similarity_computations << ", distinct edges computed:" << computed_edges
+         << ", duplicate computations:" << similarity_computations - computed_edges << ", claim conflicts:"
+         << claim_conflicts << ", signature-pruned:" << signature_pruned << ", min-hash decided:"
+         << min_hash_similar + min_hash_not_similar << "\n";
+    cout << "candidate order:" << CandidateOrderName(candidate_order) << ", check-core candidates skipped:"
+         << candidates_skipped << ", core pairs skipped by same set:" << same_set_skipped << "\n";
+}
+
+void Graph::ReportGlueBreakdown(double run_time) {
+    auto glue_time = glue_select_cores_time + glue_init_cluster_dict_time + glue_non_core_output_time +
+                     glue_edge_ids_time;
+    auto glue_fraction = run_time > 0 ? glue_time / run_time : 0.0;
+    auto thread_num = static_cast<double>(profile.schedule.thread_num);
+    cout << "glue breakdown, select cores:" << glue_select_cores_time * 1000 << " ms, init cluster_dict:"
+         << glue_init_cluster_dict_time * 1000 << " ms, size non-core output:" << glue_non_core_output_time * 1000
+         << " ms, compact edge ids:" << glue_edge_ids_time * 1000 << " ms, glue:" << glue_time * 1000 << " ms of "
+         << run_time * 1000 << " ms (" << glue_fraction * 100 << "%), speedup bound if it were serial, at "
+         << thread_num << " threads:" << 1.0 / (glue_fraction + (1.0 - glue_fraction) / thread_num)
+         << ", at 64 threads:" << 1.0 / (glue_fraction + (1.0 - glue_fraction) / 64) << "\n";
+}
+
 void Graph::PrintMinCnBeauty() {
+#ifdef USE_LOG
     map<pair<int, int>, int> dict;
     map<pair<int, int>, int> dict2;
     for (auto u = 0; u < n; u++) {
@@ -105,28 +349,24 @@ void Graph::PrintMinCnBeauty() {
     reset(ss);
     ss << dict2;
     log_info("min-cn: %s", ss.str().c_str());
+#endif
 }
 
 void Graph::PruneDetail(int u) {
     auto sd = 0;
-    auto ed = degree[u] - 1;
+    auto ed = Degree(u) - 1;
     for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
-        auto v = out_edges[edge_idx];
-        int deg_a = degree[u], deg_b = degree[v];
-        if (deg_a > deg_b) { swap(deg_a, deg_b); }
-        if (((long long) deg_a) * eps_b2 < ((long long) deg_b) * eps_a2) {
-            min_cn[edge_idx] = NOT_SIMILAR;
+        auto state = PruneState(u, edge_idx);
+        min_cn[edge_idx] = state;
+        if (state == NOT_SIMILAR) {
             ed--;
-        } else {
-            int c = ComputeCnLowerBound(deg_a, deg_b);
-            auto is_similar_flag = c <= 2;
-            min_cn[edge_idx] = is_similar_flag ? SIMILAR : c;
-            if (is_similar_flag) {
-                sd++;
-            }
+        } else if (state == SIMILAR) {
+            sd++;
         }
     }
     log_info("u: %d, sd:%d, ed:%d, sd>=min_u: %d, ed<min_u:%d", u, sd, ed, sd >= min_u, ed < min_u);
+    similar_degree[u] = sd;
+    effective_degree[u] = ed;
 
     if (sd >= min_u) {
         core_status_lst[u] = CORE;
@@ -135,252 +375,226 @@ void Graph::PruneDetail(int u) {
     }
 }
 
-void Graph::CheckCoreFirstBSP(int u) {
-    if (core_status_lst[u] == UN_KNOWN) {
-        auto sd = 0;
-        auto ed = degree[u] - 1;
-        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
-            // be careful, the next line can only be commented when memory load/store of min_cn is atomic, no torn read
-//            auto v = out_edges[edge_idx];
-//            if (u <= v) {
-            if (min_cn[edge_idx] == SIMILAR) {
-                ++sd;
-                if (sd >= min_u) {
-                    log_info("min-max-pruning-sd-ed (CORE), %d, %d, %d", u, sd, ed);
-                    core_status_lst[u] = CORE;
-                    return;
-                }
-            } else if (min_cn[edge_idx] == NOT_SIMILAR) {
-                --ed;
-                if (ed < min_u) {
-                    log_info("min-max-pruning-sd-ed (NON-CORE), %d, %d, %d", u, ed, ed);
-                    core_status_lst[u] = NON_CORE;
-                    return;
-                }
-            }
-//            }
-        }
-        log_info("init-sd-ed, %d, %d, %d", u, sd, ed);
-        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
-            auto v = out_edges[edge_idx];
-            if (u <= v && min_cn[edge_idx] > 0) {
-                min_cn[edge_idx] = EvalSimilarity(u, edge_idx);
-                min_cn[BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u)] = min_cn[edge_idx];
-                if (min_cn[edge_idx] == SIMILAR) {
-                    ++sd;
-                    if (sd >= min_u) {
-                        log_info("early-finalize (CORE), u:%d, sd:%d, ed:%d", u, sd, ed);
-                        core_status_lst[u] = CORE;
-                        return;
-                    }
-                } else {
-                    --ed;
-                    if (ed < min_u) {
-                        log_info("early-finalize (NON-CORE), u:%d, sd:%d, ed:%d", u, sd, ed);
-                        core_status_lst[u] = NON_CORE;
-                        return;
-                    }
-                }
-            }
+long Graph::CandidatePriority(int u, ui edge_idx) {
+    auto v = out_edges[edge_idx];
+    if (candidate_order == CandidateOrder::CHEAPEST) { return Degree(v); }
+    // fraction of the smaller neighborhood that must be shared, scaled to keep the integer order
+    auto min_cn_num = max(min_cn[edge_idx], 0);
+    return (static_cast<long>(min_cn_num) << 20) / min(Degree(u), Degree(v));
+}
+
+vector<ui> &Graph::OrderCandidates(int u, vector<ui> &candidates) {
+    if (candidate_order == CandidateOrder::ADJACENCY || candidates.size() < 2) { return candidates; }
+    thread_local vector<pair<long, ui>> keyed;
+    keyed.clear();
+    for (auto edge_idx: candidates) { keyed.emplace_back(CandidatePriority(u, edge_idx), edge_idx); }
+    sort(keyed.begin(), keyed.end());
+    for (auto i = 0u; i < keyed.size(); i++) { candidates[i] = keyed[i].second; }
+    return candidates;
+}
+
+void Graph::CheckCoreCandidates(int u, vector<ui> &candidates, MirrorWriter *mirror_writer) {
+    OrderCandidates(u, candidates);
+    // the interleaved steps are the unweighted merge
+    if (interleave_width > 1 && edge_weights.empty()) {
+        thread_local vector<ui> similar_edges, conflict_edges;
+        similar_edges.clear();
+        conflict_edges.clear();
+        auto issued_num = InterleaveCandidates(u, candidates, true, mirror_writer, similar_edges, conflict_edges);
+        __sync_fetch_and_add(&candidates_skipped, static_cast<long>(candidates.size() - issued_num));
+        return;
+    }
+    for (auto i = 0u; i < candidates.size(); i++) {
+        // decided by its own resolutions, or by the ones of its neighbors
+        if (core_status_lst[u] != UN_KNOWN) {
+            __sync_fetch_and_add(&candidates_skipped, static_cast<long>(candidates.size() - i));
+            return;
         }
-        log_info("finalize (NON-SURE), u:%d, sd: %d, ed:%d", u, sd, ed);
+        // an edge claimed by another worker is counted by that worker
+        if (min_cn[candidates[i]] > 0) { ComputeSimilarityOnce(u, candidates[i], false, mirror_writer); }
     }
+    log_info("finalize (NON-SURE), u:%d, sd: %d, ed:%d", u, similar_degree[u], effective_degree[u]);
 }
 
-void Graph::CheckCoreSecondBSP(int u) {
-    if (core_status_lst[u] == UN_KNOWN) {
-        auto sd = 0;
-        auto ed = degree[u] - 1;
-        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
-            if (min_cn[edge_idx] == SIMILAR) {
-                ++sd;
-                if (sd >= min_u) {
-                    log_info("min-max-pruning-sd-ed (CORE), %d, %d, %d", u, sd, ed);
-                    core_status_lst[u] = CORE;
-                    return;
-                }
-            }
-            if (min_cn[edge_idx] == NOT_SIMILAR) {
-                --ed;
-                if (ed < min_u) {
-                    log_info("min-max-pruning-sd-ed (NON-CORE), %d, %d, %d", u, sd, ed);
-                    return;
-                }
-            }
-        }
+void Graph::CheckCoreFirstBSP(int u, MirrorWriter *mirror_writer) {
+    if (core_status_lst[u] != UN_KNOWN) { return; }
+    thread_local vector<ui> candidates;
+    candidates.clear();
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        if (u <= out_edges[edge_idx] && min_cn[edge_idx] > 0) { candidates.emplace_back(edge_idx); }
+    }
+    CheckCoreCandidates(u, candidates, mirror_writer);
+}
 
-        for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
-            auto v = out_edges[edge_idx];
-            if (min_cn[edge_idx] > 0) {
-                min_cn[edge_idx] = EvalSimilarity(u, edge_idx);
-                min_cn[BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u)] = min_cn[edge_idx];
-                if (min_cn[edge_idx] == SIMILAR) {
-                    ++sd;
-                    if (sd >= min_u) {
-                        log_info("finalize (CORE), u:%d, sd: %d, ed:%d", u, sd, ed);
-                        core_status_lst[u] = CORE;
-                        return;
-                    }
-                } else {
-                    --ed;
-                    if (ed < min_u) {
-                        log_info("finalize (NON-CORE), u:%d, sd: %d, ed:%d", u, sd, ed);
-                        return;
-                    }
-                }
-            }
-        }
+void Graph::CheckCoreSecondBSP(int u, MirrorWriter *mirror_writer) {
+    // sd and ed are maintained, only the still undecided edges are touched
+    if (core_status_lst[u] != UN_KNOWN) { return; }
+    thread_local vector<ui> candidates;
+    candidates.clear();
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        if (min_cn[edge_idx] > 0) { candidates.emplace_back(edge_idx); }
     }
+    CheckCoreCandidates(u, candidates, mirror_writer);
 }
 
 void Graph::ClusterCoreFirstPhase(int u) {
     for (auto j = out_edge_start[u]; j < out_edge_start[u + 1]; j++) {
         auto v = out_edges[j];
+#ifdef USE_LOG
         bool core_v = IsDefiniteCoreVertex(v);
         bool same_set = disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u),
                                                     static_cast<uint32_t>(v));
         if (u < v && core_v)
                 log_info("u:%d, v:%d, SameSet: %d, Pruning: %d", u, v, same_set, core_v && same_set ? 1 : 0);
+#endif
         if (u < v && IsDefiniteCoreVertex(v) && !disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u),
                                                                              static_cast<uint32_t>(v))) {
             if (min_cn[j] == SIMILAR) {
                 disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
-                stringstream ss;
-                ss << *disjoint_set_ptr;
-                log_info("union u: %d, v:%d, \n%s", u, v, ss.str().c_str());
+                log_info("union u: %d, v:%d", u, v);
             }
         }
     }
 }
 
 void Graph::ClusterCoreSecondPhase(int u) {
+    thread_local vector<ui> candidates;
+    candidates.clear();
     for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
         auto v = out_edges[edge_idx];
-        bool core_v = IsDefiniteCoreVertex(v);
-        bool same_set = disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u),
-                                                    static_cast<uint32_t>(v));
-        if (u < v && core_v)
-                log_info("u:%d, v:%d, SameSet: %d, Pruning: %d", u, v, same_set, core_v && same_set ? 1 : 0);
-        if (u < v && IsDefiniteCoreVertex(v) && !disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u),
-                                                                             static_cast<uint32_t>(v))) {
-            if (min_cn[edge_idx] > 0) {
-                min_cn[edge_idx] = EvalSimilarity(u, edge_idx);
-                log_info("eval u: %d, v:%d", u, v);
-                if (min_cn[edge_idx] == SIMILAR) {
-                    disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
-                    stringstream ss;
-                    ss << *disjoint_set_ptr;
-                    log_info("union u: %d, v:%d, \n%s", u, v, ss.str().c_str());
-                }
+        if (u < v && IsDefiniteCoreVertex(v) && min_cn[edge_idx] > 0) { candidates.emplace_back(edge_idx); }
+    }
+    ClusterCoreCandidates(u, candidates);
+}
+
+void Graph::ClusterCoreCandidates(int u, vector<ui> &candidates) {
+    // likely-similar pairs first: their unions let the later pairs short-circuit on IsSameSet
+    for (auto edge_idx: OrderCandidates(u, candidates)) {
+        auto v = out_edges[edge_idx];
+#ifdef USE_LOG
+        log_info("u:%d, v:%d, SameSet: %d", u, v, disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u),
+                                                                              static_cast<uint32_t>(v)));
+#endif
+        if (disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u), static_cast<uint32_t>(v))) {
+            if (min_cn[edge_idx] > 0) { __sync_fetch_and_add(&same_set_skipped, 1); }
+            continue;
+        }
+        if (min_cn[edge_idx] > 0) {
+            log_info("eval u: %d, v:%d", u, v);
+            if (ComputeSimilarityOnce(u, edge_idx, true) == SIMILAR) {
+                disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+                log_info("union u: %d, v:%d", u, v);
             }
         }
     }
 }
 
-void Graph::ClusterNonCoreDetail(int u, vector<pair<int, int>> &tmp_cluster) {
-    for (auto j = out_edge_start[u]; j < out_edge_start[u + 1]; j++) {
-        auto v = out_edges[j];
-        if (u == 2) {
-            log_info("%d, %d", v, !IsDefiniteCoreVertex(v));
+void Graph::ReserveScratch(vector<ui> &list) {
+    if (list.capacity() < scratch_reserve) { list.reserve(scratch_reserve); }
+}
+
+void Graph::ClusterNonCoreDetail(int u, NonCoreWriter &writer) {
+    thread_local vector<ui> candidates;
+    ReserveScratch(candidates);
+    candidates.clear();
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (!IsDefiniteCoreVertex(v) && !IsAttachedAtSettle(v)) { candidates.emplace_back(edge_idx); }
+    }
+    ClusterNonCoreCandidates(u, candidates, writer);
+}
+
+void Graph::ClusterNonCoreCandidates(int u, const vector<ui> &candidates, NonCoreWriter &writer) {
+    auto cluster_id = cluster_dict[disjoint_set_ptr->FindRoot(static_cast<uint32_t>(u))];
+    if (interleave_width > 1 && edge_weights.empty()) {
+        thread_local vector<ui> similar_edges, conflict_edges;
+        ReserveScratch(similar_edges);
+        ReserveScratch(conflict_edges);
+        similar_edges.clear();
+        conflict_edges.clear();
+        InterleaveCandidates(u, candidates, false, nullptr, similar_edges, conflict_edges);
+        // claimed by another worker meanwhile: wait for its result
+        for (auto edge_idx: conflict_edges) {
+            if (ComputeSimilarityOnce(u, edge_idx, true) == SIMILAR) { similar_edges.emplace_back(edge_idx); }
         }
-        if (!IsDefiniteCoreVertex(v)) {
-            auto root_of_u = disjoint_set_ptr->FindRoot(static_cast<uint32_t>(u));
-            if (min_cn[j] > 0) {
-                min_cn[j] = EvalSimilarity(u, j);
-            }
-            if (min_cn[j] == SIMILAR) {
-                tmp_cluster.emplace_back(cluster_dict[root_of_u], v);
-            }
+        for (auto edge_idx: similar_edges) { writer.push(make_pair(cluster_id, out_edges[edge_idx])); }
+        return;
+    }
+    for (auto edge_idx: candidates) {
+        if (ComputeSimilarityOnce(u, edge_idx, true) == SIMILAR) {
+            writer.push(make_pair(cluster_id, out_edges[edge_idx]));
         }
     }
 }
 
 void Graph::pSCANFirstPhasePrune() {
     auto prune_start = high_resolution_clock::now();
-    {
-        auto thread_num = std::thread::hardware_concurrency();
-        ThreadPool pool(thread_num);
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        for (auto v_i = 0; v_i < n; v_i++) {
-            deg_sum += degree[v_i];
-            if (deg_sum > 64 * 1024) {
-                deg_sum = 0;
-
-                pool.enqueue([this](int i_start, int i_end) {
-                    for (auto u = i_start; u < i_end; u++) {
-                        PruneDetail(u);
-                    }
-                }, v_start, v_i + 1);
-                v_start = v_i + 1;
-            }
-        }
-        pool.enqueue([this](int i_start, int i_end) {
-            for (auto u = i_start; u < i_end; u++) {
-                PruneDetail(u);
-            }
-        }, v_start, n);
-    }
+    AllocateStandardLayout();
+    ExecuteLongestFirst("1st: prune", profile.schedule, n, [this](ui u) -> long {
+        return Degree(u);
+    }, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) { PruneDetail(u); }
+    });
     auto prune_end = high_resolution_clock::now();
     cout << "1st: prune execution time:" << duration_cast<milliseconds>(prune_end - prune_start).count() << " ms\n";
 }
 
+long Graph::EstimateCheckCoreCost(int u, bool is_first_bsp) {
+    if (core_status_lst[u] != UN_KNOWN) { return 0; }
+    long cost = Degree(u);
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (min_cn[edge_idx] > 0 && (!is_first_bsp || u <= v)) { cost += Degree(u) + Degree(v); }
+    }
+    return cost;
+}
+
+long Graph::EstimateClusterCost(int u, bool is_core_core) {
+    long cost = Degree(u);
+    for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+        auto v = out_edges[edge_idx];
+        if (min_cn[edge_idx] > 0 && (is_core_core ? u < v && IsDefiniteCoreVertex(v) :
+                                     !IsDefiniteCoreVertex(v) && !IsAttachedAtSettle(v))) {
+            cost += Degree(u) + Degree(v);
+        }
+    }
+    return cost;
+}
+
 void Graph::pSCANSecondPhaseCheckCore() {
     // check-core 1st phase
     auto find_core_start = high_resolution_clock::now();
-    auto thread_num = std::thread::hardware_concurrency();
-    {
-        ThreadPool pool(thread_num);
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        for (auto v_i = 0; v_i < n; v_i++) {
-            if (core_status_lst[v_i] == UN_KNOWN) {
-                deg_sum += degree[v_i];
-                if (deg_sum > 32 * 1024) {
-                    deg_sum = 0;
-                    pool.enqueue([this](int i_start, int i_end) {
-                        for (auto i = i_start; i < i_end; i++) { CheckCoreFirstBSP(i); }
-                    }, v_start, v_i + 1);
-                    v_start = v_i + 1;
-                }
-            }
-        }
-
-        pool.enqueue([this](int i_start, int i_end) {
-            for (auto i = i_start; i < i_end; i++) { CheckCoreFirstBSP(i); }
-        }, v_start, n);
+    if (is_owner_computes) {
+        mirror_partitions_ptr = yche::make_unique<MirrorPartitions>(n, out_edge_start,
+                                                                   static_cast<ui>(profile.schedule.thread_num));
+    }
+    ProcessHubs(HubPhase::CHECK_CORE_FIRST_BSP);
+    if (tile_cache_bytes > 0) {
+        TiledCheckCoreFirstBSP();
+    } else {
+        ExecuteLongestFirst("2nd: check core first-phase bsp", profile.schedule, n, [this](ui u) -> long {
+            return EstimateCheckCoreCost(u, true);
+        }, [this](ui i_start, ui i_end) {
+            auto mirror_writer = NewMirrorWriter();
+            for (auto i = i_start; i < i_end; i++) { CheckCoreFirstBSP(i, mirror_writer.get()); }
+        });
     }
+    ApplyMirrorUpdates("2nd: apply first-phase mirror updates");
     auto first_bsp_end = high_resolution_clock::now();
     cout << "2nd: check core first-phase bsp time:"
          << duration_cast<milliseconds>(first_bsp_end - find_core_start).count() << " ms\n";
     PrintMinCnBeauty();
 
     // check-core 2nd phase
-    {
-        ThreadPool pool(thread_num);
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        for (auto v_i = 0; v_i < n; v_i++) {
-            if (core_status_lst[v_i] == UN_KNOWN) {
-                deg_sum += degree[v_i];
-                if (deg_sum > 64 * 1024) {
-                    deg_sum = 0;
-                    pool.enqueue([this](int i_start, int i_end) {
-                        for (auto i = i_start; i < i_end; i++) { CheckCoreSecondBSP(i); }
-                    }, v_start, v_i + 1);
-                    v_start = v_i + 1;
-                }
-            }
-        }
-
-        pool.enqueue([this](int i_start, int i_end) {
-            for (auto i = i_start; i < i_end; i++) { CheckCoreSecondBSP(i); }
-        }, v_start, n);
-    }
-
+    ProcessHubs(HubPhase::CHECK_CORE_SECOND_BSP);
+    ExecuteLongestFirst("2nd: check core second-phase bsp", profile.schedule, n, [this](ui u) -> long {
+        return EstimateCheckCoreCost(u, false);
+    }, [this](ui i_start, ui i_end) {
+        auto mirror_writer = NewMirrorWriter();
+        for (auto i = i_start; i < i_end; i++) { CheckCoreSecondBSP(i, mirror_writer.get()); }
+    });
+    ApplyMirrorUpdates("2nd: apply second-phase mirror updates");
+    mirror_partitions_ptr.reset();
     auto second_bsp_end = high_resolution_clock::now();
     cout << "2nd: check core second-phase bsp time:"
          << duration_cast<milliseconds>(second_bsp_end - first_bsp_end).count() << " ms\n";
@@ -391,104 +605,147 @@ void Graph::pSCANSecondPhaseCheckCore() {
 void Graph::pSCANThirdPhaseClusterCore() {
     // trivial: prepare data
     auto tmp_start = high_resolution_clock::now();
-    for (auto i = 0; i < n; i++) {
-        if (IsDefiniteCoreVertex(i)) { cores.emplace_back(i); }
-    }
-    cout << "core size:" << cores.size() << "\n";
+    ParallelSelect(profile.schedule.thread_num, n, [this](ui u) { return IsDefiniteCoreVertex(u); }, cores);
     auto tmp_end0 = high_resolution_clock::now();
+    glue_select_cores_time += duration<double>(tmp_end0 - tmp_start).count();
+    cout << "core size:" << cores.size() << "\n";
     cout << "3rd: copy time: " << duration_cast<milliseconds>(tmp_end0 - tmp_start).count() << " ms\n";
 
-    // cluster-core 1st phase
-    {
-        ThreadPool pool(std::thread::hardware_concurrency());
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        for (auto core_index = 0; core_index < cores.size(); core_index++) {
-            deg_sum += degree[cores[core_index]];
-            if (deg_sum > 128 * 1024) {
-                deg_sum = 0;
-                pool.enqueue([this](int i_start, int i_end) {
+    if (is_core_subgraph) { ExtractCoreSubgraph(); }
+
+    // cluster-core 1st phase, only cheap union-find operations
+    cout << "3rd: cc engine:" << CCEngineName(cc_engine) << "\n";
+    if (cc_engine == CCEngine::AFFOREST) {
+        // batch linking of the known-similar core edges, the later phases use the same structure online
+        AfforestLink(*disjoint_set_ptr);
+    } else {
+        ExecuteLongestFirst("3rd: cluster core first-phase", profile.schedule, static_cast<ui>(cores.size()),
+                            [this](ui i) -> long {
+                                return core_subgraph_ptr != nullptr ? core_subgraph_ptr->core_core_start[i + 1] -
+                                                                      core_subgraph_ptr->core_core_start[i] + 1
+                                                                    : Degree(cores[i]);
+                            }, [this](ui i_start, ui i_end) {
                     for (auto i = i_start; i < i_end; i++) {
-                        auto u = cores[i];
-                        ClusterCoreFirstPhase(u);
+                        if (core_subgraph_ptr != nullptr) {
+                            ClusterCoreFirstPhaseCompacted(i);
+                        } else {
+                            ClusterCoreFirstPhase(cores[i]);
+                        }
                     }
-                }, v_start, core_index + 1);
-                v_start = core_index + 1;
-            }
-        }
-
-        pool.enqueue([this](int i_start, int i_end) {
-            for (auto i = i_start; i < i_end; i++) {
-                auto u = cores[i];
-                ClusterCoreFirstPhase(u);
-            }
-        }, v_start, cores.size());
+                });
     }
 
     auto tmp_end = high_resolution_clock::now();
     cout << "3rd: prepare time: " << duration_cast<milliseconds>(tmp_end - tmp_start).count() << " ms\n";
 
     // cluster-core 2nd phase
-    {
-        ThreadPool pool(std::thread::hardware_concurrency());
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        for (auto core_index = 0; core_index < cores.size(); core_index++) {
-            deg_sum += degree[cores[core_index]];
-            if (deg_sum > 128 * 1024) {
-                deg_sum = 0;
-                pool.enqueue([this](int i_start, int i_end) {
-                    for (auto i = i_start; i < i_end; i++) {
-                        auto u = cores[i];
-                        ClusterCoreSecondPhase(u);
+    ProcessHubs(HubPhase::CLUSTER_CORE);
+    ExecuteLongestFirst("3rd: cluster core second-phase", profile.schedule, static_cast<ui>(cores.size()),
+                        [this](ui i) -> long {
+                            return core_subgraph_ptr != nullptr ? EstimateCompactedClusterCost(i, true)
+                                                                : EstimateClusterCost(cores[i], true);
+                        }, [this](ui i_start, ui i_end) {
+                for (auto i = i_start; i < i_end; i++) {
+                    if (core_subgraph_ptr != nullptr) {
+                        ClusterCoreSecondPhaseCompacted(i);
+                    } else {
+                        ClusterCoreSecondPhase(cores[i]);
                     }
-                }, v_start, core_index + 1);
-                v_start = core_index + 1;
-            }
-        }
-
-        pool.enqueue([this](int i_start, int i_end) {
-            for (auto i = i_start; i < i_end; i++) {
-                auto u = cores[i];
-                ClusterCoreSecondPhase(u);
-            }
-        }, v_start, cores.size());
-    }
+                }
+            });
     auto end_core_cluster = high_resolution_clock::now();
     cout << "3rd: core clustering time:" << duration_cast<milliseconds>(end_core_cluster - tmp_start).count()
          << " ms\n";
 }
 
 void Graph::MarkClusterMinEleAsId() {
-    auto thread_num = std::thread::hardware_concurrency();
-    ThreadPool pool(thread_num);
-    auto step = max(1u, n / thread_num);
-    for (auto outer_i = 0u; outer_i < n; outer_i += step) {
-        pool.enqueue([this](ui i_start, ui i_end) {
-            for (auto i = i_start; i < i_end; i++) {
-                if (IsDefiniteCoreVertex(i)) {
-                    int x = disjoint_set_ptr->FindRoot(i);
-                    int cluster_min_ele;
-                    do {
-                        // assume no torn read of cluster_dict[x]
-                        cluster_min_ele = cluster_dict[x];
-                        if (i >= cluster_dict[x]) {
-                            break;
-                        }
-                    } while (!__sync_bool_compare_and_swap(&cluster_dict[x], cluster_min_ele, i));
-                }
+    ParallelForStatic(profile.schedule.thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            if (IsDefiniteCoreVertex(i)) {
+                auto u = static_cast<int>(i);
+                int x = disjoint_set_ptr->FindRoot(i);
+                int cluster_min_ele;
+                do {
+                    // assume no torn read of cluster_dict[x]
+                    cluster_min_ele = cluster_dict[x];
+                    if (u >= cluster_dict[x]) {
+                        break;
+                    }
+                } while (!__sync_bool_compare_and_swap(&cluster_dict[x], cluster_min_ele, u));
             }
-        }, outer_i, min(outer_i + step, n));
-    }
+        }
+    });
 }
 
-void Graph::pSCANFourthPhaseClusterNonCore() {
-    // mark cluster label
-    noncore_cluster = std::vector<pair<int, int>>();
-    noncore_cluster.reserve(n);
+ui Graph::NonCorePairBound() {
+    if (core_subgraph_ptr != nullptr) { return core_subgraph_ptr->core_non_core_start[cores.size()]; }
+    return ParallelReduce(profile.schedule.thread_num, static_cast<ui>(cores.size()), 0u, [this](ui i_start,
+                                                                                               ui i_end) {
+        auto local_bound = 0u;
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = cores[i];
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (!IsClusteredCore(out_edges[edge_idx])) { ++local_bound; }
+            }
+        }
+        return local_bound;
+    });
+}
 
+void Graph::CollectNonCoreClusters(const char *phase_name, ui pair_bound, const function<long(ui)> &cost_func,
+                                   const function<void(ui, NonCoreWriter &)> &collect_func) {
+    auto pair_start = static_cast<ui>(noncore_cluster.size());
+    noncore_cluster.resize(pair_start + pair_bound);
+    atomic<ui> pair_end(pair_start);
+    // scratch lists of a worker reserved to the largest core degree in its first task
+    ParallelForStatic(profile.schedule.thread_num, static_cast<ui>(cores.size()), [this](ui i_start, ui i_end) {
+        auto local_max = 0u;
+        for (auto i = i_start; i < i_end; i++) { local_max = max(local_max, static_cast<ui>(Degree(cores[i]))); }
+        auto global_max = scratch_reserve;
+        while (local_max > global_max && !__sync_bool_compare_and_swap(&scratch_reserve, global_max, local_max)) {
+            global_max = scratch_reserve;
+        }
+    });
+    long task_allocations = 0, warm_task_allocations = 0;
+    // workers of this call that ran a task, the first task of each warms up its thread-local candidate lists
+    mutex worker_mutex;
+    vector<thread::id> warm_workers;
+    warm_workers.reserve(profile.schedule.thread_num + 1);
+    ExecuteLongestFirst(phase_name, profile.schedule, static_cast<ui>(cores.size()), cost_func,
+                        [this, &collect_func, &pair_end, &task_allocations, &warm_task_allocations, &worker_mutex,
+                                &warm_workers](ui i_start, ui i_end) {
+                            auto is_warm = false;
+#if defined(COUNT_ALLOCATIONS)
+                            {
+                                lock_guard<mutex> lock(worker_mutex);
+                                auto worker = this_thread::get_id();
+                                is_warm = find(warm_workers.begin(), warm_workers.end(), worker) != warm_workers.end();
+                                if (!is_warm) { warm_workers.emplace_back(worker); }
+                            }
+#endif
+                            auto allocations_before = ThreadAllocationCount();
+
+                            pair<int, int> local_memory[NON_CORE_LOCAL_BUFFER_CAP];
+                            NonCoreWriter writer(local_memory, NON_CORE_LOCAL_BUFFER_CAP, noncore_cluster.data(),
+                                                 &pair_end);
+                            for (auto i = i_start; i < i_end; i++) { collect_func(i, writer); }
+                            writer.submit_if_possible();
+
+                            auto allocations = ThreadAllocationCount() - allocations_before;
+                            __sync_fetch_and_add(&task_allocations, allocations);
+                            if (is_warm) { __sync_fetch_and_add(&warm_task_allocations, allocations); }
+                        });
+    scratch_reserve = 0;
+    noncore_cluster.resize(pair_end);
+    cout << phase_name << ", pairs:" << pair_end - pair_start << " of bound:" << pair_bound;
+#if defined(COUNT_ALLOCATIONS)
+    cout << ", heap allocations in tasks:" << task_allocations << ", after the first task of each worker:"
+         << warm_task_allocations;
+#endif
+    cout << "\n";
+}
+
+void Graph::pSCANFourthPhaseClusterNonCore() {
     auto tmp_start = high_resolution_clock::now();
     MarkClusterMinEleAsId();
 
@@ -497,43 +754,22 @@ void Graph::pSCANFourthPhaseClusterNonCore() {
          << duration_cast<milliseconds>(tmp_next_start - tmp_start).count() << " ms\n";
 
     // cluster non-core 2nd phase
-    {
-        ThreadPool pool(std::thread::hardware_concurrency());
-
-        auto v_start = 0;
-        long deg_sum = 0;
-        vector<future<vector<pair<int, int>>>> future_vec;
-        for (auto core_index = 0; core_index < cores.size(); core_index++) {
-            deg_sum += degree[cores[core_index]];
-            if (deg_sum > 32 * 1024) {
-                deg_sum = 0;
-                future_vec.emplace_back(pool.enqueue([this](int i_start, int i_end) -> vector<pair<int, int>> {
-                    auto tmp_cluster = vector<pair<int, int>>();
-                    for (auto i = i_start; i < i_end; i++) {
-                        auto u = cores[i];
-                        ClusterNonCoreDetail(u, tmp_cluster);
-                    }
-                    return tmp_cluster;
-                }, v_start, core_index + 1));
-                v_start = core_index + 1;
-            }
-        }
-
-        future_vec.emplace_back(pool.enqueue([this](int i_start, int i_end) -> vector<pair<int, int>> {
-            auto tmp_cluster = vector<pair<int, int>>();
-            for (auto i = i_start; i < i_end; i++) {
-                auto u = cores[i];
-                ClusterNonCoreDetail(u, tmp_cluster);
-            }
-            return tmp_cluster;
-        }, v_start, cores.size()));
-
-        for (auto &future: future_vec) {
-            for (auto ele:future.get()) {
-                noncore_cluster.emplace_back(ele);
-            };
+    // one output array sized to the candidate pairs, each task writes through a stack buffer
+    auto bound_start = high_resolution_clock::now();
+    auto pair_bound = NonCorePairBound();
+    noncore_cluster = std::vector<pair<int, int>>();
+    glue_non_core_output_time += duration<double>(high_resolution_clock::now() - bound_start).count();
+    CollectNonCoreClusters("4th: cluster non-core", pair_bound, [this](ui i) -> long {
+        return core_subgraph_ptr != nullptr ? EstimateCompactedClusterCost(i, false)
+                                            : EstimateClusterCost(cores[i], false);
+    }, [this](ui i, NonCoreWriter &writer) {
+        if (core_subgraph_ptr != nullptr) {
+            ClusterNonCoreCompacted(i, writer);
+        } else {
+            ClusterNonCoreDetail(cores[i], writer);
         }
-    }
+    });
+    core_subgraph_ptr.reset();
 
     auto all_end = high_resolution_clock::now();
     cout << "4th: non-core clustering time:" << duration_cast<milliseconds>(all_end - tmp_start).count()
@@ -541,17 +777,30 @@ void Graph::pSCANFourthPhaseClusterNonCore() {
 }
 
 void Graph::pSCAN() {
-    cout << "new algorithm ppSCAN" << endl;
-    pSCANFirstPhasePrune();
-    PrintMinCnBeauty();
-
-    pSCANSecondPhaseCheckCore();
+    cout << "new algorithm ppSCAN, runtime:" << RuntimeName() << ", threads:" << profile.schedule.thread_num
+         << ", similarity:" << Similarity::NAME << endl;
+    auto run_start = high_resolution_clock::now();
+    // the option combinations are resolved by the caller, see main.cpp
+    auto engine = similarity_engine == SimilarityEngine::AUTO ? ChooseSimilarityEngine() : similarity_engine;
+    cout << "similarity engine:" << SimilarityEngineName(engine) << "\n";
+
+    auto undecided_after_prune = 0l;
+    if (engine == SimilarityEngine::ALL_EDGE) {
+        AllEdgeSimilarity();
+    } else {
+        pSCANFirstPhasePrune();
+        PrintMinCnBeauty();
+        undecided_after_prune = CountUndecidedEdges();
+
+        pSCANSecondPhaseCheckCore();
+    }
     PrintMinCnBeauty();
 
-
     pSCANThirdPhaseClusterCore();
     PrintMinCnBeauty();
 
     pSCANFourthPhaseClusterNonCore();
     PrintMinCnBeauty();
+    ReportSimilarityComputations(undecided_after_prune);
+    ReportGlueBreakdown(duration<double>(high_resolution_clock::now() - run_start).count());
 }
\ No newline at end of file
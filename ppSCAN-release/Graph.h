@@ -1,11 +1,29 @@
 #ifndef PPSCAN_GRAPH_H_
 #define PPSCAN_GRAPH_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <future>
 
+#include "AllEdgeSimilarity.h"
+#include "Anytime.h"
+#include "AutoTuner.h"
+#include "BucketSignature.h"
+#include "CandidateOrder.h"
+#include "ClusterSummary.h"
+#include "CompactLayout.h"
+#include "ConnectedComponents.h"
+#include "CoreSubgraph.h"
+#include "HubSplitting.h"
 #include "InputOutput.h"
+#include "Interleave.h"
+#include "MinHash.h"
+#include "MirrorBuffer.h"
+#include "SimilarityPolicy.h"
+#include "Tiling.h"
 #include "Util.h"
+#include "WeightedSimilarity.h"
 
 using namespace std;
 
@@ -15,13 +33,20 @@ using EdgeVec = vector<int, hbw::allocator<int>>;
 using EdgeVec = vector<int>;
 #endif
 
+// per-task writer of the non-core results (cluster id, non-core vertex) into noncore_cluster, stack-buffered
+constexpr ui NON_CORE_LOCAL_BUFFER_CAP = 512;
+using NonCoreWriter = LocalWriteBuffer<pair<int, int>, ui, atomic<ui>>;
+
 // Graph instance: fast consumption object
 class Graph {
 private:
+    string dir;
     unique_ptr<InputOutput> io_helper_ptr;
-    // parameter1: e.g eps: 0.13, eps_a:13, eps_b:100;
+    // parameter1: e.g eps: 0.13, eps_a:13, eps_b:100, held by the similarity policy of the binary
     // parameter2: min_u: 5, 5 nearest neighbor as threshold
-    int eps_a2, eps_b2, min_u;
+    Similarity similarity;
+    double eps;
+    int min_u;
 
     // compressed spare row graph
     ui n;
@@ -34,11 +59,12 @@ private:
 #endif
 
     // edge properties
-    int *min_cn; //minimum common neighbor: -2 means not similar; -1 means similar; 0 means not sure; > 0 means the minimum common neighbor
+    int *min_cn; //minimum common neighbor: -2 means not similar; -1 means similar; 0 means in progress; > 0 means the minimum common neighbor
 
     // vertex properties
-    vector<int> degree;
     vector<char> core_status_lst;
+    int *similar_degree;    // number of adjacent edges known to be similar, maintained atomically
+    int *effective_degree;  // number of adjacent edges not known to be dissimilar, maintained atomically
 
     // clusters: core and non-core(hubs)
     int *cluster_dict;    // observation 2: core vertex clusters are disjoint
@@ -46,16 +72,100 @@ private:
     // first: cluster id(min core-vertex id in cluster), second: non-core vertex id
     vector<pair<int, int>> noncore_cluster; // observation 1: clusters may overlap, observation 3: non-core uniquely determined by core
 
-    // disjoint-set: used for core-vertex induced connected components
-    unique_ptr<DisjointSets> disjoint_set_ptr;
+    // disjoint-set: used for core-vertex induced connected components, engine selectable
+    CCEngine cc_engine;
+    unique_ptr<CoreUnionFind> disjoint_set_ptr;
 
     vector<int> cores;
 
+    // dense cluster ids and statistics, built on request after a run
+    ClusterSummary summary;
+
+    // claim protocol statistics
+    long similarity_computations;
+    long claim_conflicts;
+
+    // signature test before the intersection kernels, nullptr if disabled
+    unique_ptr<BucketSignatures> signatures_ptr;
+    long signature_pruned;
+
+    // weighted cosine, empty if unweighted: weights aligned with out_edges (symmetric, self weight 1), norms of the
+    // closed neighborhoods and the largest weight of each adjacency list
+    vector<float> edge_weights;
+    vector<double> weight_norms;
+    vector<float> max_weights;
+
+    // approximate mode: minhash decisions before the kernels, nullptr if disabled
+    unique_ptr<MinHashSketches> min_hash_ptr;
+    long min_hash_similar;
+    long min_hash_not_similar;
+
+    // similarity engine of pSCAN, and the common-neighbor counts of every adjacency entry kept for the export
+    SimilarityEngine similarity_engine;
+    bool is_export_similarity;
+    vector<int> edge_common_num;
+
+    // candidate ordering, candidates left when a vertex is decided and pairs short-circuited by the disjoint sets
+    CandidateOrder candidate_order;
+    long candidates_skipped;
+    long same_set_skipped;
+
+    // glue between the parallel phases, seconds: cores selection, cluster_dict init, sizing of the non-core output,
+    // undirected edge ids of the compact layout
+    double glue_select_cores_time;
+    double glue_init_cluster_dict_time;
+    double glue_non_core_output_time;
+    double glue_edge_ids_time;
+
+    // interleaved mode: in-flight intersections per worker, 1 means one at a time with the selected kernel
+    ui interleave_width;
+
+    // tiled mode: cache budget of a tile pair in bytes, 0 means vertex-ordered check-core
+    size_t tile_cache_bytes;
+
+    // core subgraph mode: clustering phases over the extracted core edges, built after check-core
+    bool is_core_subgraph;
+    unique_ptr<CoreSubgraph> core_subgraph_ptr;
+
+    // owner-computes mode: deferred mirror writes, applied per destination partition after each check-core round
+    bool is_owner_computes;
+    unique_ptr<MirrorPartitions> mirror_partitions_ptr;
+
+    // dataflow mode: a core settles (issues its unions) as soon as it is decided
+    vector<char> is_settled;
+    vector<char> is_pruned_non_core;    // decided by pruning, attached to the cores at settle time
+    vector<pair<int, int>> settled_attachments;  // first: core vertex id, second: non-core vertex id
+
+    // compact mode: 2-bit undirected edge states, status bitsets and 4-byte disjoint sets, nullptr otherwise
+    unique_ptr<CompactLayout> compact_ptr;
+
+    // thread number, task granularity and intersection kernel, possibly loaded from a tune profile
+    TuneProfile profile;
+
 private:
     void PrintMinCnBeauty();
 
-    // easy-computation pruning optimization: common-neighbor check pruning, as a pre-processing phase
-    int ComputeCnLowerBound(int u, int v);
+    // inclusive degree, derived from the offsets
+    int Degree(int u) const { return static_cast<int>(out_edge_start[u + 1] - out_edge_start[u]) + 1; }
+
+    // easy-computation pruning optimization: degree test and common-neighbor threshold, as a pre-processing phase;
+    // NOT_SIMILAR, SIMILAR, or the threshold for the kernels
+    int PruneState(int u, ui edge_idx);
+
+    // weighted: the bounds from the edge weight and the largest weights, WEIGHTED_UNDECIDED for the kernels
+    int WeightedPruneState(int u, ui edge_idx);
+
+    // sum of w(u, x) * w(v, x) over the common neighbors against eps * |u| * |v|
+    int EvalWeightedSimilarity(int u, ui edge_idx);
+
+    // merge from the offsets with the partial sum, stopping when the sum reaches the target or the remaining
+    // elements matched with the largest weights cannot
+    int IntersectWeighted(int u, int v, ui offset_u, ui offset_v, double sum, double target);
+
+#if defined(ENABLE_AVX2)
+    // 8x8 blocks compared in 8 rotations, the weights rotated with the ids and multiplied under the match masks
+    int IntersectWeightedAVX2(int u, int v, double sum, double target);
+#endif
 
     int IntersectNeighborSets(int u, int v, int min_cn_num);
 
@@ -81,29 +191,149 @@ private:
     int IntersectNeighborSetsAVX512MergePopCnt(int u, int v, int min_cn_num);
 #endif
 
+    bool IsSignaturePruned(int u, int v, int min_cn_num);
+
+    // SIMILAR or NOT_SIMILAR decided from the sketches, 0 for the exact kernels
+    int MinHashDecide(int u, int v, int min_cn_num);
+
     int EvalSimilarity(int u, ui edge_idx);
 
+    // the exact kernel of the build (or of the tune profile), without the signature and minhash counters
+    int IntersectSelectedKernel(int u, int v, int min_cn_num);
+
+    int EvalSimilarity(int u, ui edge_idx, int min_cn_num);
+
     // avoiding redundant computation optimization: find reverse edge index, e.g, (i,j) index know, compute (j,i) index
     ui BinarySearch(EdgeVec &array, ui offset_beg, ui offset_end, int val);
 
     bool IsDefiniteCoreVertex(int u);
 
+    // check-core: sd/ed maintenance, a vertex is decided the moment one of its thresholds is crossed
+    void UpdateDegree(int u, int result);
+
+    void ResolveEdge(int u, ui edge_idx, int result);
+
+    // claim protocol: each undirected similarity is computed at most once per run
+    int ClaimEdge(int u, ui edge_idx, bool is_wait, ui &reverse_edge_idx);
+
+    void PublishClaimedEdge(int u, ui edge_idx, ui reverse_edge_idx, int result, MirrorWriter *mirror_writer);
+
+    int ComputeSimilarityOnce(int u, ui edge_idx, bool is_wait, MirrorWriter *mirror_writer = nullptr);
+
+    // interleaved mode: claimed candidates evaluated as round-robin resumable merges
+    // true if the edge is claimed and needs a merge, else result holds the decision or IN_PROGRESS
+    bool StartIntersection(int u, ui edge_idx, IntersectionState &state, MirrorWriter *mirror_writer, int &result);
+
+    int StepIntersection(IntersectionState &state);
+
+    // returns the number of candidates issued, the conflicting ones are left to the caller
+    ui InterleaveCandidates(int u, const vector<ui> &candidates, bool is_check_core, MirrorWriter *mirror_writer,
+                            vector<ui> &similar_edges, vector<ui> &conflict_edges);
+
+    unique_ptr<MirrorWriter> NewMirrorWriter();
+
+    void ApplyMirrorUpdates(const char *phase_name);
+
+    long CountUndecidedEdges();
+
+    void ReportSimilarityComputations(long undecided_after_prune);
+
+    // share of the glue steps in the run and the speedup bound if they ran serially
+    void ReportGlueBreakdown(double run_time);
+
+    // cost model for task partitioning: estimated intersection work of a vertex, 0 means no work
+    long EstimateCheckCoreCost(int u, bool is_first_bsp);
+
+    long EstimateClusterCost(int u, bool is_core_core);
+
+    // mega-hub splitting: edges of hubs processed as edge-range sub-tasks across all workers
+    bool IsHub(int u);
+
+    // all hubs ascending, selected on the first ProcessHubs and filtered by each phase
+    bool is_hub_selected;
+    vector<int> hub_vertices;
+
+    int CountCommonNeighborsInPiece(int u, int v, int piece, int pieces);
+
+    void PublishHubEdge(HubPhase phase, int u, ui edge_idx, int result);
+
+    void ProcessHubs(HubPhase phase);
+
+    // dataflow mode: core-core unions and pruned non-core attachments of a core, once it is decided
+    bool IsAttachedAtSettle(int v);
+
+    long EstimateSettleCost(int u);
+
+    void SettleCore(int u, vector<pair<int, int>> &attachments);
+
+    ui UndirectedEdgeId(int u, ui edge_idx);
+
+    void CompactUpdateDegree(int u, int result);
+
+    int CompactComputeOnce(int u, ui edge_idx, bool is_wait);
+
+    void CompactCheckCore(int u, bool is_first_bsp);
+
+    void ReportBytesPerEdge();
+
+    // auto-tuning: time of the check-core intersections of the sampled vertices under the current profile
+    double ProbeCheckCore(const vector<int> &sample);
+
 private:
+    // per-vertex ordering of the undecided edges, lower priority first
+    long CandidatePriority(int u, ui edge_idx);
+
+    vector<ui> &OrderCandidates(int u, vector<ui> &candidates);
+
+    void CheckCoreCandidates(int u, vector<ui> &candidates, MirrorWriter *mirror_writer);
+
+    // tiled mode: first check-core round over the pending edges bucketed by tile pair
+    bool IsTilePending(int u, ui edge_idx);
+
+    void TiledCheckCoreFirstBSP();
+
     // vertex computations in each phase
     void PruneDetail(int u);
 
-    void CheckCoreFirstBSP(int u);
+    void CheckCoreFirstBSP(int u, MirrorWriter *mirror_writer);
 
-    void CheckCoreSecondBSP(int u);
+    void CheckCoreSecondBSP(int u, MirrorWriter *mirror_writer);
 
     void ClusterCoreFirstPhase(int u);
 
     void ClusterCoreSecondPhase(int u);
 
-    void ClusterNonCoreDetail(int u, vector<pair<int, int>> &tmp_cluster);
+    void ClusterCoreCandidates(int u, vector<ui> &candidates);
+
+    void ClusterNonCoreDetail(int u, NonCoreWriter &writer);
+
+    void ClusterNonCoreCandidates(int u, const vector<ui> &candidates, NonCoreWriter &writer);
+
+    // connected-components engines: Afforest batch linking of the known-similar core edges
+    bool IsKnownSimilarCoreEdge(ui edge_idx);
+
+    void AfforestLink(ConcurrentUnionFind &sets);
+
+    // cluster summary: core status and set root of the standard or the compact layout
+    bool IsClusteredCore(int u);
+
+    int ClusterRoot(int u);
+
+    // core subgraph mode, i is the index in cores
+    void ExtractCoreSubgraph();
+
+    long EstimateCompactedClusterCost(ui i, bool is_core_core);
+
+    void ClusterCoreFirstPhaseCompacted(ui i);
+
+    void ClusterCoreSecondPhaseCompacted(ui i);
+
+    void ClusterNonCoreCompacted(ui i, NonCoreWriter &writer);
 
 private:
     // computation stages
+    void AllocateStandardLayout();
+
     void pSCANFirstPhasePrune();
 
     void pSCANSecondPhaseCheckCore();
@@ -112,15 +342,119 @@ private:
 
     void MarkClusterMinEleAsId();
 
+    // thread-local scratch lists reserved once to scratch_reserve entries, 0 outside of the non-core phases
+    ui scratch_reserve;
+
+    void ReserveScratch(vector<ui> &list);
+
+    // core to non-core adjacency entries, at least the number of non-core results
+    ui NonCorePairBound();
+
+    // non-core tasks over the cores, collect(i, writer) for core index i; results appended to noncore_cluster,
+    // sized to the bound beforehand, and the heap allocations inside the tasks reported
+    void CollectNonCoreClusters(const char *phase_name, ui pair_bound, const function<long(ui)> &cost_func,
+                                const function<void(ui, NonCoreWriter &)> &collect_func);
+
     void pSCANFourthPhaseClusterNonCore();
 
+    void pSCANDataflowCheckCore();
+
+    void pSCANDataflowClusterNonCore();
+
+    // anytime: block sizes in vertices (check-core) and cores (cluster-core)
+    ui alpha_block_size;
+    ui beta_block_size;
+
+    // union a definite core with its definite core neighbors over known-similar edges, both directions
+    void AnytimeLink(int u);
+
+    // report the counts after a block, false to stop: budget exceeded or the callback declined
+    bool PublishAnytimeProgress(const char *stage, ui block, ui block_num, bool is_exact, double elapsed_ms,
+                                double budget_ms, const AnytimeCallback &callback);
+
+    // result of a stopped anytime run: the definite cores, non-cores attached by known-similar edges only
+    void MaterializeApproximation();
+
+    // all-edge engine: the exact state of every edge from triangle counting, replacing prune and check-core
+    void AllEdgeSimilarity();
+
+    // auto engine: all-edge when the pruning leaves most of the sampled edges undecided
+    SimilarityEngine ChooseSimilarityEngine();
+
 public:
     explicit Graph(const char *dir_string, const char *eps_s, int min_u);
 
+    // check-core mirror writes by the partition owning the destination, instead of by the resolving worker
+    void SetOwnerComputes(bool is_owner_computes);
+
+    // per-phase task and busy-time lines of ExecuteLongestFirst
+    void SetBusyReport(bool is_busy_report);
+
+    void SetCandidateOrder(CandidateOrder order);
+
+    void SetInterleaveWidth(ui width);
+
+    void SetTileCacheBytes(size_t cache_bytes);
+
+    void SetCoreSubgraph(bool is_core_subgraph);
+
+    void SetCCEngine(CCEngine engine);
+
+    // after a run: every engine on the known-similar core-core edges, timed and checked against the run
+    void BenchmarkCCEngines();
+
+    // build the bucket-histogram signatures with the given number of buckets, enabling the test
+    void SetSignatureBuckets(ui bucket_num);
+
+    // weighted cosine from b_weight.bin, the norms computed in parallel; false if the file is absent
+    bool SetWeighted();
+
+    // approximate: edges outside the error band of the minhash estimate are decided without a merge
+    void SetMinHash(double error_rate, ui hash_num = DEFAULT_MIN_HASH_NUM);
+
+    void SetSimilarityEngine(SimilarityEngine engine);
+
+    // keep the common-neighbor counts for OutputSimilarities, runs pSCAN with the all-edge engine
+    void SetSimilarityExport(bool is_export_similarity);
+
     void pSCAN();
 
+    // same results as pSCAN, without the barriers of core clustering
+    void pSCANDataflow();
+
+    // same results as pSCAN, with the compact layout: less memory, pruning bounds recomputed on every visit
+    void pSCANCompact();
+
+    void SetAnytimeBlockSizes(ui alpha_block_size, ui beta_block_size);
+
+    // pSCAN in blocks with the progress published after each, stopping at a block boundary once the budget
+    // (0: none) is exceeded or the callback declines; the result is exact unless stopped
+    void pSCANAnytime(double budget_ms, const AnytimeCallback &callback = AnytimeCallback());
+
+    // search thread number, task granularity and kernel on a sample, save the profile for later runs
+    void AutoTune();
+
     void Output(const char *eps_s, const char *miu);
 
+    // after a run: clusters relabelled to [0, k) by minimum core id, sizes, memberships and size histogram
+    void BuildClusterSummary();
+
+    // after a run: every vertex outside the clusters as hub (adjacent to 2+ clusters) or outlier
+    void ClassifyHubsOutliers();
+
+    const ClusterSummary &GetClusterSummary() const;
+
+    // hub and outlier lines appended to the result file, roles-<eps>-<mu>.bin with one VertexRole byte per vertex
+    void OutputRoles(const char *eps_s, const char *miu);
+
+    void OutputSummary(const char *eps_s, const char *miu);
+
+    // after an all-edge run: similarity-<eps>-<mu>.bin with the similarity of every adjacency entry, m floats
+    void OutputSimilarities(const char *eps_s, const char *miu);
+
+    // after both runs: clusters, core status, adjusted rand index and decided edges against an exact run
+    void ReportAgreement(Graph &exact);
+
     virtual ~Graph();
 };
 
@@ -0,0 +1,163 @@
+#include "Graph.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace yche;
+
+bool Graph::IsHub(int u) {
+    return Degree(u) >= HUB_DEGREE_THRESHOLD;
+}
+
+int Graph::CountCommonNeighborsInPiece(int u, int v, int piece, int pieces) {
+    if (Degree(u) > Degree(v)) { swap(u, v); }
+    // piece of u's neighbors by position, the matching value range [lower, upper) of v's neighbors by search
+    auto len_u = out_edge_start[u + 1] - out_edge_start[u];
+    auto off_nei_u = out_edge_start[u] + static_cast<ui>(static_cast<unsigned long>(len_u) * piece / pieces);
+    auto off_u_end = out_edge_start[u] + static_cast<ui>(static_cast<unsigned long>(len_u) * (piece + 1) / pieces);
+    if (off_nei_u >= off_u_end) { return 0; }
+
+    auto v_beg = out_edges.begin() + out_edge_start[v], v_end = out_edges.begin() + out_edge_start[v + 1];
+    auto off_nei_v = static_cast<ui>(lower_bound(v_beg, v_end, out_edges[off_nei_u]) - out_edges.begin());
+    auto off_v_end = off_u_end == out_edge_start[u + 1] ? out_edge_start[v + 1] :
+                     static_cast<ui>(lower_bound(out_edges.begin() + off_nei_v, v_end, out_edges[off_u_end]) -
+                                     out_edges.begin());
+    auto cn = 0;
+    while (off_nei_u < off_u_end && off_nei_v < off_v_end) {
+        if (out_edges[off_nei_u] < out_edges[off_nei_v]) {
+            ++off_nei_u;
+        } else if (out_edges[off_nei_u] > out_edges[off_nei_v]) {
+            ++off_nei_v;
+        } else {
+            ++cn;
+            ++off_nei_u;
+            ++off_nei_v;
+        }
+    }
+    return cn;
+}
+
+void Graph::PublishHubEdge(HubPhase phase, int u, ui edge_idx, int result) {
+    if (phase == HubPhase::CLUSTER_CORE) {
+        // split hub-hub edges are gathered only by the smaller endpoint, no claim needed
+        __sync_fetch_and_add(&similarity_computations, 1);
+        min_cn[edge_idx] = result;
+        if (result == SIMILAR) {
+            disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(out_edges[edge_idx]));
+        }
+        return;
+    }
+    // counted by the maintained sd/ed of both endpoints, unless resolved meanwhile
+    ResolveEdge(u, edge_idx, result);
+}
+
+void Graph::ProcessHubs(HubPhase phase) {
+    auto is_check_core = phase != HubPhase::CLUSTER_CORE;
+    if (!is_hub_selected) {
+        ParallelSelect(profile.schedule.thread_num, n, [this](ui u) { return IsHub(u); }, hub_vertices);
+        is_hub_selected = true;
+    }
+    vector<int> hubs;
+    for (auto u: hub_vertices) {
+        if (is_check_core ? core_status_lst[u] == UN_KNOWN : IsDefiniteCoreVertex(u)) { hubs.emplace_back(u); }
+    }
+    if (hubs.empty()) { return; }
+
+    // 1st: per hub, gather the undecided edges
+    vector<vector<HubWorkItem>> hub_items(hubs.size());
+    vector<vector<pair<int, int>>> hub_splits(hubs.size());   // (min_cn, pieces) of the split intersections
+    ExecuteLongestFirst("hub gather", profile.schedule, static_cast<ui>(hubs.size()), [this, &hubs](ui i) -> long {
+        return Degree(hubs[i]);
+    }, [&, this](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto u = hubs[i];
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto v = out_edges[edge_idx];
+                if (min_cn[edge_idx] > 0 &&
+                    ((phase == HubPhase::CHECK_CORE_FIRST_BSP && u <= v) ||
+                     // a split hub-hub edge is gathered once, by the smaller hub if both are undecided
+                     (phase == HubPhase::CHECK_CORE_SECOND_BSP &&
+                      (u < v || !IsHub(v) || core_status_lst[v] != UN_KNOWN)) ||
+                     (phase == HubPhase::CLUSTER_CORE && u < v && IsDefiniteCoreVertex(v)))) {
+                    // the split pieces count common neighbors, weighted edges are intersected whole
+                    if (IsHub(v) && edge_weights.empty()) {
+                        auto pieces = min(Degree(u), Degree(v)) / SPLIT_PIECE_SIZE + 1;
+                        for (auto piece = 0; piece < pieces; piece++) {
+                            hub_items[i].push_back({i, edge_idx, piece, static_cast<ui>(hub_splits[i].size())});
+                        }
+                        hub_splits[i].emplace_back(min_cn[edge_idx], pieces);
+                    } else {
+                        hub_items[i].push_back({i, edge_idx, -1, 0});
+                    }
+                }
+            }
+        }
+    });
+
+    // 2nd: flat worklist over all hubs
+    vector<HubWorkItem> items;
+    vector<pair<int, int>> splits;
+    for (auto i = 0u; i < hubs.size(); i++) {
+        for (auto item: hub_items[i]) {
+            if (item.piece >= 0) { item.split_idx += splits.size(); }
+            items.emplace_back(item);
+        }
+        splits.insert(splits.end(), hub_splits[i].begin(), hub_splits[i].end());
+        vector<HubWorkItem>().swap(hub_items[i]);
+    }
+    auto split_num = splits.size();
+    unique_ptr<SplitPairState[]> split_states(new SplitPairState[split_num]);
+    for (auto i = 0u; i < split_num; i++) {
+        split_states[i].min_cn_num = splits[i].first;
+        split_states[i].pieces = splits[i].second;
+        split_states[i].cn = 2;  // count for u and v
+        split_states[i].pieces_left = splits[i].second;
+        split_states[i].is_aborted = false;
+    }
+    cout << "hub num:" << hubs.size() << ", hub edge sub-tasks:" << items.size()
+         << ", split intersections:" << split_num << "\n";
+
+    // 3rd: edge-range sub-tasks, a hub stops as soon as it is decided
+    ExecuteLongestFirst("hub edge-range", profile.schedule, static_cast<ui>(items.size()), [&, this](ui i) -> long {
+        auto u = hubs[items[i].hub_idx], v = out_edges[items[i].edge_idx];
+        return items[i].piece < 0 ? Degree(u) + Degree(v) :
+               (Degree(u) + Degree(v)) / split_states[items[i].split_idx].pieces;
+    }, [&, this](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) {
+            auto &item = items[i];
+            auto u = hubs[item.hub_idx];
+            auto is_decided = is_check_core && core_status_lst[u] != UN_KNOWN;
+            auto v = out_edges[item.edge_idx];
+            if (!is_check_core && disjoint_set_ptr->IsSameSet(static_cast<uint32_t>(u), static_cast<uint32_t>(v))) {
+                is_decided = true;
+            }
+
+            if (item.piece < 0) {
+                if (is_decided) { continue; }
+                // possibly resolved by the mirror of another hub meanwhile
+                auto result = ComputeSimilarityOnce(u, item.edge_idx, !is_check_core);
+                if (!is_check_core && result == SIMILAR) {
+                    disjoint_set_ptr->Union(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+                }
+            } else {
+                auto &split = split_states[item.split_idx];
+                if (is_decided) {
+                    split.is_aborted = true;
+                } else if (split.cn.load() < split.min_cn_num) {
+                    split.cn += CountCommonNeighborsInPiece(u, v, item.piece, split.pieces);
+                }
+                if (split.pieces_left.fetch_sub(1) == 1) {
+                    auto cn = split.cn.load();
+                    if (cn >= split.min_cn_num) {
+                        PublishHubEdge(phase, u, item.edge_idx, SIMILAR);
+                    } else if (!split.is_aborted) {
+                        PublishHubEdge(phase, u, item.edge_idx, NOT_SIMILAR);
+                    }
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,33 @@
+#ifndef PPSCAN_HUB_SPLITTING_H
+#define PPSCAN_HUB_SPLITTING_H
+
+#include <atomic>
+
+using ui=unsigned int;
+
+// mega-hub: vertices with degree no less than the threshold are expanded into edge-range sub-tasks
+constexpr int HUB_DEGREE_THRESHOLD = 8 * 1024;
+// an intersection of two mega-hubs is split by value range into pieces of about this many elements
+constexpr int SPLIT_PIECE_SIZE = 2 * 1024;
+
+enum class HubPhase {
+    CHECK_CORE_FIRST_BSP, CHECK_CORE_SECOND_BSP, CLUSTER_CORE
+};
+
+// value-range split intersection, the last finished piece publishes the result
+struct SplitPairState {
+    int min_cn_num;
+    int pieces;
+    std::atomic<int> cn;
+    std::atomic<int> pieces_left;
+    std::atomic<bool> is_aborted;
+};
+
+struct HubWorkItem {
+    ui hub_idx;     // index of the hub
+    ui edge_idx;    // edge (u, out_edges[edge_idx])
+    int piece;      // -1: the whole intersection, otherwise the piece id of split_idx
+    ui split_idx;
+};
+
+#endif //PPSCAN_HUB_SPLITTING_H
@@ -6,6 +6,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <thread>
+
+#include "ParallelRuntime.h"
 
 InputOutput::InputOutput(const string &dir) : dir(dir) {}
 
@@ -38,15 +41,21 @@ void InputOutput::ReadAdjacencyList() {
     offset_out_edges.resize(n + 1);
     out_edges.resize(m);
 
-    offset_out_edges[0] = 0;
-    for (auto i = 0; i < n; i++) { offset_out_edges[i + 1] = offset_out_edges[i] + degree[i]; }
+    // offsets: parallel scan of the degrees, the machine's threads since no tune profile is loaded yet
+    auto thread_num = static_cast<size_t>(max(thread::hardware_concurrency(), 1u));
+    ParallelForStatic(thread_num, n, [this](ui i_start, ui i_end) {
+        copy(degree.begin() + i_start, degree.begin() + i_end, offset_out_edges.begin() + i_start);
+    });
+    ParallelExclusiveScan(thread_num, offset_out_edges);
     for (auto i = 0; i < n; i++) {
         if (degree[i] > 0) {
             adj_file.read(reinterpret_cast<char *>(&out_edges[offset_out_edges[i]]), degree[i] * sizeof(int));
         }
-        // inclusive
-        degree[i]++;
     }
+    // inclusive
+    ParallelForStatic(thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto i = i_start; i < i_end; i++) { degree[i]++; }
+    });
 
     auto end = high_resolution_clock::now();
     cout << "read adjacency list file time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
@@ -71,6 +80,21 @@ void InputOutput::CheckInputGraph() {
     cout << "check input graph file time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
 }
 
+bool InputOutput::ReadWeights(vector<float> &weights) {
+    auto start = high_resolution_clock::now();
+    ifstream weight_file(dir + string("/b_weight.bin"), ios::binary);
+    if (!weight_file) { return false; }
+    weights.resize(m);
+    weight_file.read(reinterpret_cast<char *>(weights.data()), sizeof(float) * m);
+    if (weight_file.gcount() != static_cast<streamsize>(sizeof(float) * m)) {
+        weights.clear();
+        return false;
+    }
+    auto end = high_resolution_clock::now();
+    cout << "read weight file time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
+    return true;
+}
+
 void InputOutput::ReadGraph() {
     ReadDegree();
     ReadAdjacencyList();
@@ -95,7 +119,7 @@ pair<int, int> InputOutput::ParseEps(const char *eps_s) {
         cout << "eps err\n";
         exit(1);
     }
-    return make_pair(eps_numerator * eps_numerator, eps_denominator * eps_denominator);
+    return make_pair(eps_numerator, eps_denominator);
 }
 
 // possible duplicates in noncore_cluster, sd_lst need to be checked with a cmp
@@ -192,7 +216,7 @@ void InputOutput::OutputAnySCAN(const char *eps_s, const char *min_u, vector<pai
 }
 
 void InputOutput::Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
-                         vector<char> &is_core_lst, vector<int> &cid, DisjointSets &disjoint_sets) {
+                         vector<char> &is_core_lst, vector<int> &cid, ConcurrentUnionFind &disjoint_sets) {
     string out_name = dir + "/result-" + string(eps_s) + "-" + string(min_u) + ".txt";
     ofstream ofs(out_name);
     ofs << "c/n vertex_id cluster_id\n";
@@ -229,7 +253,7 @@ void InputOutput::Output(const char *eps_s, const char *min_u, vector<pair<int,
 }
 
 void InputOutput::Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
-                         vector<char> &is_core_lst, int *cid, DisjointSets &disjoint_sets) {
+                         vector<char> &is_core_lst, int *cid, ConcurrentUnionFind &disjoint_sets) {
     string out_name = dir + "/result-" + string(eps_s) + "-" + string(min_u) + ".txt";
     ofstream ofs(out_name);
     ofs << "c/n vertex_id cluster_id\n";
@@ -248,4 +272,68 @@ void InputOutput::Output(const char *eps_s, const char *min_u, vector<pair<int,
              [&ofs](pair<int, int> my_pair) { ofs << "n " << my_pair.second << " " << my_pair.first << "\n"; });
 }
 
+void InputOutput::Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
+                         vector<uint64_t> &core_bits, CompactDisjointSets &disjoint_sets) {
+    string out_name = dir + "/result-" + string(eps_s) + "-" + string(min_u) + ".txt";
+    ofstream ofs(out_name);
+    ofs << "c/n vertex_id cluster_id\n";
 
+    // observation 2: unique belonging
+    for (auto i = 0; i < n; i++) {
+        if ((core_bits[i >> 6] >> (i & 63)) & 1u) {
+            ofs << "c " << i << " " << disjoint_sets.FindRoot(static_cast<uint32_t>(i)) << "\n";
+        }
+    }
+
+    // possibly multiple belongings
+    sort(noncore_cluster.begin(), noncore_cluster.end());
+    auto iter_end = unique(noncore_cluster.begin(), noncore_cluster.end());
+    for_each(noncore_cluster.begin(), iter_end,
+             [&ofs](pair<int, int> my_pair) { ofs << "n " << my_pair.second << " " << my_pair.first << "\n"; });
+}
+
+void InputOutput::OutputSummary(const char *eps_s, const char *min_u, const ClusterSummary &summary) {
+    string out_name = dir + "/summary-" + string(eps_s) + "-" + string(min_u) + ".txt";
+    ofstream ofs(out_name);
+    ofs << "clusters " << summary.cluster_num << "\n";
+    ofs << "non-core members " << summary.non_core_member_num << "\n";
+    ofs << "shared non-cores " << summary.shared_non_core_num << "\n";
+
+    if (!summary.role.empty()) {
+        ofs << "hubs " << summary.hub_num << "\n";
+        ofs << "outliers " << summary.outlier_num << "\n";
+    }
+
+    ofs << "size_from size_to clusters\n";
+    for (auto b = 0u; b < SIZE_HISTOGRAM_BUCKETS; b++) {
+        if (summary.size_histogram[b] > 0) {
+            ofs << (1ul << b) << " " << (1ul << (b + 1)) - 1 << " " << summary.size_histogram[b] << "\n";
+        }
+    }
+
+    ofs << "cluster_id size cores non_cores\n";
+    for (auto c = 0u; c < summary.cluster_num; c++) {
+        ofs << c << " " << summary.Size(c) << " " << summary.core_num[c] << " " << summary.non_core_num[c] << "\n";
+    }
+}
+
+void InputOutput::OutputRoles(const char *eps_s, const char *min_u, const ClusterSummary &summary) {
+    string out_name = dir + "/result-" + string(eps_s) + "-" + string(min_u) + ".txt";
+    ofstream ofs(out_name, ios::app);
+    for (auto i = 0; i < n; i++) {
+        if (summary.role[i] == HUB) { ofs << "h " << i << "\n"; }
+    }
+    for (auto i = 0; i < n; i++) {
+        if (summary.role[i] == OUTLIER) { ofs << "o " << i << "\n"; }
+    }
+
+    string bin_name = dir + "/roles-" + string(eps_s) + "-" + string(min_u) + ".bin";
+    ofstream bin_ofs(bin_name, ios::binary);
+    bin_ofs.write(summary.role.data(), summary.role.size());
+}
+
+void InputOutput::OutputSimilarities(const char *eps_s, const char *min_u, const vector<float> &similarities) {
+    string bin_name = dir + "/similarity-" + string(eps_s) + "-" + string(min_u) + ".bin";
+    ofstream bin_ofs(bin_name, ios::binary);
+    bin_ofs.write(reinterpret_cast<const char *>(similarities.data()), sizeof(float) * similarities.size());
+}
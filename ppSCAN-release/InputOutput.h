@@ -10,6 +10,8 @@
 #include <atomic>
 #include <unordered_set>
 
+#include "ClusterSummary.h"
+#include "ConnectedComponents.h"
 #include "ThreadSafeDisjointSet.h"
 #include "Util.h"
 #include "DisjointSet.h"
@@ -65,6 +67,9 @@ public:
 
     void ReadGraph();
 
+    // optional b_weight.bin: one float per entry of b_adj.bin, false if absent or short
+    bool ReadWeights(vector<float> &weights);
+
     pair<int, int> ParseEps(const char *eps_s);
 
     // possible duplicates in noncore_cluster, sd_lst need to be checked with a cmp
@@ -88,14 +93,28 @@ public:
 
     // accept disjoint sets directly
     void Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
-                vector<char> &is_core_lst, vector<int> &cid, DisjointSets &disjoint_sets);
+                vector<char> &is_core_lst, vector<int> &cid, ConcurrentUnionFind &disjoint_sets);
+
+    void Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
+                vector<char> &is_core_lst, int *cid, ConcurrentUnionFind &disjoint_sets);
 
+    // compact layout: core bitset, the root of a core's set is its cluster id
     void Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
-                vector<char> &is_core_lst, int *cid, DisjointSets &disjoint_sets);
+                vector<uint64_t> &core_bits, CompactDisjointSets &disjoint_sets);
 
     // cid has all core-induced cluster info
     void Output(const char *eps_s, const char *min_u, vector<pair<int, int>> &noncore_cluster,
                 vector<bool> &is_core_lst, vector<int> &cid);
+
+    // summary-<eps>-<min_u>.txt: totals, size histogram, then per dense cluster id its size, cores and non-cores
+    void OutputSummary(const char *eps_s, const char *min_u, const ClusterSummary &summary);
+
+    // "h vertex_id"/"o vertex_id" lines appended to result-<eps>-<min_u>.txt, one role byte per vertex in
+    // roles-<eps>-<min_u>.bin
+    void OutputRoles(const char *eps_s, const char *min_u, const ClusterSummary &summary);
+
+    // similarity-<eps>-<mu>.bin: one float per entry of b_adj.bin, in the same order
+    void OutputSimilarities(const char *eps_s, const char *min_u, const vector<float> &similarities);
 };
 
 #endif //PPSCAN_INPUTOUTPUT_H
\ No newline at end of file
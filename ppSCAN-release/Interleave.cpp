@@ -0,0 +1,94 @@
+#include "Graph.h"
+
+#include "util/log/log.h"
+
+using namespace yche;
+
+bool Graph::StartIntersection(int u, ui edge_idx, IntersectionState &state, MirrorWriter *mirror_writer,
+                              int &result) {
+    auto v = out_edges[edge_idx];
+    result = ClaimEdge(u, edge_idx, false, state.reverse_edge_idx);
+    if (result <= 0) { return false; }
+    // decided without a merge: the signature test, then the minhash sketches, as in EvalSimilarity
+    auto decision = IsSignaturePruned(u, v, result) ? NOT_SIMILAR : MinHashDecide(u, v, result);
+    if (decision != 0) {
+        PublishClaimedEdge(u, edge_idx, state.reverse_edge_idx, decision, mirror_writer);
+        result = decision;
+        return false;
+    }
+    state.v = v;
+    state.edge_idx = edge_idx;
+    state.offset_u = out_edge_start[u];
+    state.offset_v = out_edge_start[v];
+    state.cn = 2;
+    state.du = Degree(u) + 1;
+    state.dv = Degree(v) + 1;
+    state.min_cn_num = result;
+    __builtin_prefetch(out_edges.data() + state.offset_v);
+    return true;
+}
+
+int Graph::StepIntersection(IntersectionState &state) {
+    // same comparisons as IntersectNeighborSets, the pruning bounds keep the offsets in range
+    for (auto i = 0; i < INTERLEAVE_STEP_COMPARISONS; i++) {
+        auto nei_u = out_edges[state.offset_u], nei_v = out_edges[state.offset_v];
+        if (nei_u < nei_v) {
+            if (--state.du < state.min_cn_num) { return NOT_SIMILAR; }
+            ++state.offset_u;
+        } else if (nei_u > nei_v) {
+            if (--state.dv < state.min_cn_num) { return NOT_SIMILAR; }
+            ++state.offset_v;
+        } else {
+            if (++state.cn >= state.min_cn_num) { return SIMILAR; }
+            ++state.offset_u;
+            ++state.offset_v;
+        }
+    }
+    __builtin_prefetch(out_edges.data() + state.offset_u + INTERLEAVE_PREFETCH_DISTANCE);
+    __builtin_prefetch(out_edges.data() + state.offset_v + INTERLEAVE_PREFETCH_DISTANCE);
+    return IN_PROGRESS;
+}
+
+ui Graph::InterleaveCandidates(int u, const vector<ui> &candidates, bool is_check_core, MirrorWriter *mirror_writer,
+                               vector<ui> &similar_edges, vector<ui> &conflict_edges) {
+    IntersectionState slots[MAX_INTERLEAVE_WIDTH];
+    // check-core: no more in flight than the resolutions u needs at least before it can be decided,
+    // one at a time they would all be evaluated as well, so nothing is computed beyond that
+    auto issue_width = [this, u, is_check_core]() -> ui {
+        if (!is_check_core) { return interleave_width; }
+        if (core_status_lst[u] != UN_KNOWN) { return 0; }
+        auto sd = __atomic_load_n(&similar_degree[u], __ATOMIC_RELAXED);
+        auto ed = __atomic_load_n(&effective_degree[u], __ATOMIC_RELAXED);
+        return static_cast<ui>(max(1, min(min(min_u - sd, ed - min_u + 1), static_cast<int>(interleave_width))));
+    };
+    auto active_num = 0u;
+    auto issued_num = 0u;
+    while (true) {
+        // issue: fill the free slots
+        while (issued_num < candidates.size() && active_num < issue_width()) {
+            auto edge_idx = candidates[issued_num++];
+            int result;
+            if (StartIntersection(u, edge_idx, slots[active_num], mirror_writer, result)) {
+                ++active_num;
+            } else if (result == SIMILAR) {
+                similar_edges.emplace_back(edge_idx);
+            } else if (result == IN_PROGRESS) {
+                conflict_edges.emplace_back(edge_idx);
+            }
+        }
+        if (active_num == 0) { break; }
+
+        // round-robin: one step of each in-flight merge, finished ones are published and their slots compacted
+        for (auto i = 0u; i < active_num;) {
+            auto result = StepIntersection(slots[i]);
+            if (result == IN_PROGRESS) {
+                i++;
+                continue;
+            }
+            PublishClaimedEdge(u, slots[i].edge_idx, slots[i].reverse_edge_idx, result, mirror_writer);
+            if (result == SIMILAR) { similar_edges.emplace_back(slots[i].edge_idx); }
+            slots[i] = slots[--active_num];
+        }
+    }
+    return issued_num;
+}
@@ -0,0 +1,28 @@
+#ifndef PPSCAN_INTERLEAVE_H
+#define PPSCAN_INTERLEAVE_H
+
+using ui=unsigned int;
+
+/*
+ * interleaved mode (AMAC): a worker keeps several claimed intersections in flight as resumable merges,
+ * each step consumes about one cache line of the two lists and prefetches the next ones before switching
+ */
+constexpr ui DEFAULT_INTERLEAVE_WIDTH = 8;
+constexpr ui MAX_INTERLEAVE_WIDTH = 32;
+constexpr int INTERLEAVE_STEP_COMPARISONS = 16;  // 16 ints: one cache line
+constexpr int INTERLEAVE_PREFETCH_DISTANCE = 16;
+
+// the scalar merge of IntersectNeighborSets, with its position saved between the steps
+struct IntersectionState {
+    int v;
+    ui edge_idx;
+    ui reverse_edge_idx;
+    ui offset_u;
+    ui offset_v;
+    int cn;
+    int du;
+    int dv;
+    int min_cn_num;
+};
+
+#endif //PPSCAN_INTERLEAVE_H
@@ -0,0 +1,121 @@
+#include "Graph.h"
+
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+void Graph::SetMinHash(double error_rate, ui hash_num) {
+    auto start = high_resolution_clock::now();
+    min_hash_ptr = yche::make_unique<MinHashSketches>(n, hash_num, error_rate);
+    auto row_len = min_hash_ptr->hash_num;
+    ParallelForStatic(profile.schedule.thread_num, n, [this, row_len](ui i_start, ui i_end) {
+        vector<uint64_t> min_hashes(row_len);
+        for (auto u = i_start; u < i_end; u++) {
+            fill(min_hashes.begin(), min_hashes.end(), UINT64_MAX);
+            // the closed neighborhood, as the kernels count it
+            auto add = [&min_hashes, row_len](int v) {
+                for (auto i = 0u; i < row_len; i++) {
+                    min_hashes[i] = min(min_hashes[i], MinHashSketches::Hash(static_cast<uint64_t>(v), i));
+                }
+            };
+            add(u);
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                add(out_edges[edge_idx]);
+            }
+            auto row = min_hash_ptr->Row(u);
+            for (auto i = 0u; i < row_len; i++) { row[i] = static_cast<uint8_t>(min_hashes[i]); }
+        }
+    });
+    auto end = high_resolution_clock::now();
+    cout << "min-hash sketches:" << row_len << ", error rate:" << error_rate << ", z:" << min_hash_ptr->z
+         << ", construct time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
+}
+
+int Graph::MinHashDecide(int u, int v, int min_cn_num) {
+    auto du = Degree(u), dv = Degree(v);
+    if (min_hash_ptr == nullptr || min(du, dv) < MIN_HASH_MIN_DEGREE) { return 0; }
+    auto decision = min_hash_ptr->Decide(u, v, du, dv, min_cn_num);
+    if (decision > 0) {
+        __sync_fetch_and_add(&min_hash_similar, 1);
+        return SIMILAR;
+    }
+    if (decision < 0) {
+        __sync_fetch_and_add(&min_hash_not_similar, 1);
+        return NOT_SIMILAR;
+    }
+    return 0;
+}
+
+void Graph::ReportAgreement(Graph &exact) {
+    if (summary.dense_id.empty()) { BuildClusterSummary(); }
+    if (exact.summary.dense_id.empty()) { exact.BuildClusterSummary(); }
+    auto thread_num = profile.schedule.thread_num;
+
+    // edges decided in both runs (the standard layouts), the exact kernels never disagree
+    auto is_edge_comparable = compact_ptr == nullptr && exact.compact_ptr == nullptr;
+    auto edge_packed = !is_edge_comparable ? 0ul : ParallelReduce(thread_num, n, 0ul, [this, &exact](
+            ui i_start, ui i_end) {
+        auto local_packed = 0ul;
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (static_cast<int>(u) > out_edges[edge_idx] || min_cn[edge_idx] > 0 ||
+                    exact.min_cn[edge_idx] > 0) { continue; }
+                local_packed += 1ul << 32;
+                if (min_cn[edge_idx] != exact.min_cn[edge_idx]) { ++local_packed; }
+            }
+        }
+        return local_packed;
+    });
+
+    // core status
+    auto core_diff_num = ParallelReduce(thread_num, n, 0u, [this, &exact](ui i_start, ui i_end) {
+        auto local_num = 0u;
+        for (auto u = i_start; u < i_end; u++) {
+            if (IsClusteredCore(u) != exact.IsClusteredCore(u)) { ++local_num; }
+        }
+        return local_num;
+    });
+
+    // adjusted rand index of the cluster labels on the vertices that are cores in both runs
+    vector<pair<int, int>> labels;
+    for (auto u = 0u; u < n; u++) {
+        if (summary.dense_id[u] >= 0 && exact.summary.dense_id[u] >= 0) {
+            labels.emplace_back(summary.dense_id[u], exact.summary.dense_id[u]);
+        }
+    }
+    auto pairs = [](double x) { return x * (x - 1) / 2; };
+    auto sum_pairs_of_runs = [&pairs](vector<int> keys) {
+        sort(keys.begin(), keys.end());
+        auto sum = 0.0;
+        for (size_t beg = 0, end; beg < keys.size(); beg = end) {
+            for (end = beg; end < keys.size() && keys[end] == keys[beg]; end++) {}
+            sum += pairs(end - beg);
+        }
+        return sum;
+    };
+    sort(labels.begin(), labels.end());
+    auto joint_sum = 0.0;
+    for (size_t beg = 0, end; beg < labels.size(); beg = end) {
+        for (end = beg; end < labels.size() && labels[end] == labels[beg]; end++) {}
+        joint_sum += pairs(end - beg);
+    }
+    vector<int> first_keys(labels.size()), second_keys(labels.size());
+    for (size_t i = 0; i < labels.size(); i++) {
+        first_keys[i] = labels[i].first;
+        second_keys[i] = labels[i].second;
+    }
+    auto first_sum = sum_pairs_of_runs(std::move(first_keys));
+    auto second_sum = sum_pairs_of_runs(std::move(second_keys));
+    auto expected = labels.size() > 1 ? first_sum * second_sum / pairs(labels.size()) : 0.0;
+    auto max_index = (first_sum + second_sum) / 2;
+    auto ari = max_index > expected ? (joint_sum - expected) / (max_index - expected) : 1.0;
+
+    cout << "agreement with the exact run, clusters:" << summary.cluster_num << "/" << exact.summary.cluster_num
+         << ", core status differences:" << core_diff_num << "/" << n << ", adjusted rand index on common cores:"
+         << ari << " (" << labels.size() << " cores)";
+    if (is_edge_comparable) {
+        cout << ", decided edges:" << (edge_packed >> 32) << ", disagreeing:" << (edge_packed & 0xffffffffu);
+    }
+    cout << ", min-hash decided similar/not similar:" << min_hash_similar << "/" << min_hash_not_similar << "\n";
+}
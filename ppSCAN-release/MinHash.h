@@ -0,0 +1,88 @@
+#ifndef PPSCAN_MIN_HASH_H
+#define PPSCAN_MIN_HASH_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <immintrin.h>
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * b-bit minhash sketches (b = 8) of the closed neighborhoods: a hash agrees with probability
+ * p = J + (1 - J) / 2^b for the jaccard J of N[u] and N[v], and cn >= min_cn iff J >= min_cn / (du + dv - min_cn);
+ * an edge is decided from the sketches when the agreement fraction is outside p(threshold) +- z * sigma, z the
+ * one-sided normal quantile of the error rate, otherwise it falls through to the exact kernels
+ */
+constexpr ui DEFAULT_MIN_HASH_NUM = 64;
+constexpr ui MIN_HASH_ALIGN = 32;               // uint8 lanes of an avx2 register
+constexpr double DEFAULT_MIN_HASH_ERROR = 0.01;
+constexpr int MIN_HASH_MIN_DEGREE = 32;         // below, the normal approximation is poor and merges are cheap
+
+class MinHashSketches {
+public:
+    ui hash_num;
+    double z;                   // one-sided normal quantile of the error rate
+    vector<uint8_t> sketches;   // n rows of hash_num lowest bytes of the minimum hashes
+
+    MinHashSketches(ui n, ui hash_num, double error_rate) :
+            hash_num((max(hash_num, 1u) + MIN_HASH_ALIGN - 1) / MIN_HASH_ALIGN * MIN_HASH_ALIGN),
+            z(NormalQuantile(1 - error_rate)), sketches(static_cast<size_t>(n) * this->hash_num, 0) {}
+
+    uint8_t *Row(int u) { return &sketches[static_cast<size_t>(u) * hash_num]; }
+
+    static uint64_t Hash(uint64_t x, ui i) {
+        // splitmix64 finalizer, one seed per hash function
+        x += (i + 1) * 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    int Matches(int u, int v) const {
+        auto row_u = &sketches[static_cast<size_t>(u) * hash_num];
+        auto row_v = &sketches[static_cast<size_t>(v) * hash_num];
+        auto matches = 0;
+#if defined(__AVX2__)
+        for (auto i = 0u; i < hash_num; i += 32) {
+            auto eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_u + i)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_v + i)));
+            matches += __builtin_popcount(static_cast<ui>(_mm256_movemask_epi8(eq)));
+        }
+#elif defined(__SSE4_1__)
+        for (auto i = 0u; i < hash_num; i += 16) {
+            auto eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row_u + i)),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i *>(row_v + i)));
+            matches += __builtin_popcount(static_cast<ui>(_mm_movemask_epi8(eq)));
+        }
+#else
+        for (auto i = 0u; i < hash_num; i++) { matches += row_u[i] == row_v[i] ? 1 : 0; }
+#endif
+        return matches;
+    }
+
+    // 1 similar, -1 not similar, 0 undecided, for closed degrees du, dv
+    int Decide(int u, int v, int du, int dv, int min_cn_num) const {
+        auto union_num = du + dv - min_cn_num;
+        if (union_num <= min_cn_num) { return 0; }
+        auto jaccard = static_cast<double>(min_cn_num) / union_num;
+        auto p = jaccard + (1 - jaccard) / 256.0;
+        auto band = z * sqrt(p * (1 - p) / hash_num);
+        auto fraction = static_cast<double>(Matches(u, v)) / hash_num;
+        return fraction >= p + band ? 1 : (fraction <= p - band ? -1 : 0);
+    }
+
+    static double NormalQuantile(double q) {
+        // bisection on the upper tail 0.5 * erfc(x / sqrt(2)) = 1 - q
+        auto lo = -10.0, hi = 10.0;
+        for (auto i = 0; i < 100; i++) {
+            auto mid = (lo + hi) / 2;
+            if (0.5 * erfc(mid / sqrt(2.0)) > 1 - q) { lo = mid; } else { hi = mid; }
+        }
+        return (lo + hi) / 2;
+    }
+};
+
+#endif //PPSCAN_MIN_HASH_H
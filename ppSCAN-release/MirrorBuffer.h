@@ -0,0 +1,69 @@
+#ifndef PPSCAN_MIRROR_BUFFER_H
+#define PPSCAN_MIRROR_BUFFER_H
+
+#include <algorithm>
+#include <vector>
+
+#include "util/primitives/local_buffer.h"
+
+using ui=unsigned int;
+using namespace std;
+
+// owner-computes mode: the mirror copy of a resolved edge and the counters of the other endpoint v
+// are written by the partition owning v in a later sweep, instead of by the resolving worker
+struct MirrorUpdate {
+    ui edge_idx;    // the copy of the edge in v's adjacency
+    int v;
+    int result;
+};
+
+// 16 * 12 bytes: 3 cache lines per destination partition
+constexpr ui MIRROR_LOCAL_BUFFER_CAP = 16;
+
+// vertex-range partitions, partition p owns the region [out_edge_start[beg_p], out_edge_start[end_p]) of the
+// update array: at most one update per edge copy and round, so a region never overflows
+class MirrorPartitions {
+public:
+    ui partition_num;
+    ui partition_vertex_num;
+    vector<ui> region_beg;
+    vector<ui> region_size;
+    vector<MirrorUpdate> updates;
+
+    MirrorPartitions(ui n, const vector<ui> &out_edge_start, ui partition_num) :
+            partition_num(partition_num), partition_vertex_num((n + partition_num - 1) / partition_num),
+            region_beg(partition_num), region_size(partition_num, 0), updates(out_edge_start[n]) {
+        for (ui p = 0; p < partition_num; p++) { region_beg[p] = out_edge_start[min(n, p * partition_vertex_num)]; }
+    }
+
+    ui PartitionOf(int v) const { return static_cast<ui>(v) / partition_vertex_num; }
+};
+
+// per-task writer, one local buffer per destination partition, flushed on destruction
+class MirrorWriter {
+    MirrorPartitions &partitions_;
+    vector<MirrorUpdate> local_memory_;
+    vector<LocalWriteBuffer<MirrorUpdate, ui>> buffers_;
+
+public:
+    explicit MirrorWriter(MirrorPartitions &partitions) :
+            partitions_(partitions), local_memory_(partitions.partition_num * MIRROR_LOCAL_BUFFER_CAP) {
+        buffers_.reserve(partitions.partition_num);
+        for (ui p = 0; p < partitions.partition_num; p++) {
+            buffers_.emplace_back(&local_memory_[p * MIRROR_LOCAL_BUFFER_CAP], MIRROR_LOCAL_BUFFER_CAP,
+                                  &partitions.updates[partitions.region_beg[p]], &partitions.region_size[p]);
+        }
+    }
+
+    MirrorWriter(const MirrorWriter &) = delete;
+
+    ~MirrorWriter() {
+        for (auto &buffer: buffers_) { buffer.submit_if_possible(); }
+    }
+
+    void Push(int v, ui edge_idx, int result) {
+        buffers_[partitions_.PartitionOf(v)].push({edge_idx, v, result});
+    }
+};
+
+#endif //PPSCAN_MIRROR_BUFFER_H
@@ -0,0 +1,247 @@
+#ifndef PPSCAN_PARALLEL_RUNTIME_H
+#define PPSCAN_PARALLEL_RUNTIME_H
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#if defined(RUNTIME_OPENMP)
+
+#include <omp.h>
+
+#elif defined(RUNTIME_TBB)
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
+
+#else
+
+#include "ThreadPool.h"
+
+#endif
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * parallel-for/reduce of the phase loops, backend selected at compile time:
+ * RUNTIME_OPENMP (OpenMP), RUNTIME_TBB (Intel TBB), otherwise the ThreadPool
+ */
+
+// [beg, end) contiguous range of items, cost is the sum of the estimated item costs
+struct RangeTask {
+    ui beg;
+    ui end;
+    long cost;
+};
+
+inline const char *RuntimeName() {
+#if defined(RUNTIME_OPENMP)
+    return "OpenMP";
+#elif defined(RUNTIME_TBB)
+    return "TBB";
+#else
+    return "ThreadPool";
+#endif
+}
+
+// static split of [0, size) into about 4 chunks per thread, func(beg, end)
+template<typename F>
+void ParallelForStatic(size_t thread_num, ui size, F func) {
+    auto step = static_cast<ui>(size / (thread_num * 4) + 1);
+#if defined(RUNTIME_OPENMP)
+#pragma omp parallel for num_threads(thread_num) schedule(static, 1)
+    for (long outer_i = 0; outer_i < static_cast<long>(size); outer_i += step) {
+        func(static_cast<ui>(outer_i), min(static_cast<ui>(outer_i) + step, size));
+    }
+#elif defined(RUNTIME_TBB)
+    tbb::task_arena arena(static_cast<int>(thread_num));
+    arena.execute([&]() {
+        tbb::parallel_for(tbb::blocked_range<ui>(0, size, step), [&](const tbb::blocked_range<ui> &r) {
+            func(r.begin(), r.end());
+        });
+    });
+#else
+    ThreadPool pool(thread_num);
+    for (ui outer_i = 0; outer_i < size; outer_i += step) {
+        pool.enqueue([&func](ui i_start, ui i_end) { func(i_start, i_end); }, outer_i, min(outer_i + step, size));
+    }
+#endif
+}
+
+// static split as above, func(beg, end) returns the partial result, partial results are summed
+template<typename T, typename F>
+T ParallelReduce(size_t thread_num, ui size, T init, F func) {
+    auto step = static_cast<ui>(size / (thread_num * 4) + 1);
+#if defined(RUNTIME_OPENMP)
+    auto result = init;
+#pragma omp parallel for num_threads(thread_num) schedule(static, 1) reduction(+:result)
+    for (long outer_i = 0; outer_i < static_cast<long>(size); outer_i += step) {
+        result += func(static_cast<ui>(outer_i), min(static_cast<ui>(outer_i) + step, size));
+    }
+    return result;
+#elif defined(RUNTIME_TBB)
+    tbb::task_arena arena(static_cast<int>(thread_num));
+    return arena.execute([&]() {
+        return tbb::parallel_reduce(tbb::blocked_range<ui>(0, size, step), init,
+                                    [&](const tbb::blocked_range<ui> &r, T partial) {
+                                        return partial + func(r.begin(), r.end());
+                                    }, [](T l, T r) { return l + r; });
+    });
+#else
+    auto chunk_num = (size + step - 1) / step;
+    vector<T> partial(chunk_num, T());
+    {
+        ThreadPool pool(thread_num);
+        for (ui chunk = 0; chunk < chunk_num; chunk++) {
+            pool.enqueue([&func, &partial, chunk, step, size]() {
+                partial[chunk] = func(chunk * step, min(chunk * step + step, size));
+            });
+        }
+    }
+    auto result = init;
+    for (auto &p: partial) { result += p; }
+    return result;
+#endif
+}
+
+// dynamic dispatch of the tasks in the given order, func(beg, end); per-worker busy seconds into busy_time
+template<typename F>
+void ParallelForTasks(size_t thread_num, const vector<RangeTask> &tasks, F func, vector<double> &busy_time) {
+#if defined(RUNTIME_OPENMP)
+    using namespace std::chrono;
+    busy_time.assign(thread_num, 0.0);
+    // dynamic with chunk 1 hands iterations out in order, keeping longest-first
+#pragma omp parallel for num_threads(thread_num) schedule(dynamic, 1)
+    for (long i = 0; i < static_cast<long>(tasks.size()); i++) {
+        auto start = high_resolution_clock::now();
+        func(tasks[i].beg, tasks[i].end);
+        busy_time[omp_get_thread_num()] += duration<double>(high_resolution_clock::now() - start).count();
+    }
+#elif defined(RUNTIME_TBB)
+    using namespace std::chrono;
+    busy_time.assign(thread_num, 0.0);
+    tbb::task_arena arena(static_cast<int>(thread_num));
+    // work stealing splits the range recursively, so the order is only roughly longest-first
+    arena.execute([&]() {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size(), 1), [&](const tbb::blocked_range<size_t> &r) {
+            for (auto i = r.begin(); i < r.end(); i++) {
+                auto start = high_resolution_clock::now();
+                func(tasks[i].beg, tasks[i].end);
+                busy_time[tbb::this_task_arena::current_thread_index()] +=
+                        duration<double>(high_resolution_clock::now() - start).count();
+            }
+        }, tbb::simple_partitioner());
+    });
+#else
+    ThreadPool pool(thread_num, &busy_time);
+    for (auto &task: tasks) { pool.enqueue([&func](ui i_start, ui i_end) { func(i_start, i_end); }, task.beg, task.end); }
+#endif
+}
+
+// glue primitives below: one inline block for a single thread or a small input, the pool start-up would dominate
+constexpr ui PARALLEL_GLUE_MIN_SIZE = 1u << 16;
+
+inline ui GlueBlockNum(size_t thread_num, size_t size) {
+    return thread_num == 1 || size < PARALLEL_GLUE_MIN_SIZE ? 1u : static_cast<ui>(thread_num * 4);
+}
+
+template<typename F>
+void ForEachGlueBlock(size_t thread_num, ui block_num, F func) {
+    if (block_num == 1) {
+        func(0u, 1u);
+    } else {
+        ParallelForStatic(thread_num, block_num, func);
+    }
+}
+
+// in-place exclusive prefix sum of values[0, size), values[size] receives the total: per-block sums in parallel,
+// block offsets serially, then the blocks are scanned in parallel
+template<typename T>
+void ParallelExclusiveScan(size_t thread_num, vector<T> &values) {
+    auto size = static_cast<ui>(values.size() - 1);
+    auto block_num = GlueBlockNum(thread_num, size);
+    auto step = size / block_num + 1;
+    vector<T> block_offset(block_num + 1, T());
+    ForEachGlueBlock(thread_num, block_num, [&values, &block_offset, step, size](ui b_start, ui b_end) {
+        for (auto b = b_start; b < b_end; b++) {
+            auto sum = T();
+            for (auto i = b * step; i < min(b * step + step, size); i++) { sum += values[i]; }
+            block_offset[b + 1] = sum;
+        }
+    });
+    for (ui b = 0; b < block_num; b++) { block_offset[b + 1] += block_offset[b]; }
+    ForEachGlueBlock(thread_num, block_num, [&values, &block_offset, step, size](ui b_start, ui b_end) {
+        for (auto b = b_start; b < b_end; b++) {
+            auto acc = block_offset[b];
+            for (auto i = b * step; i < min(b * step + step, size); i++) {
+                auto value = values[i];
+                values[i] = acc;
+                acc += value;
+            }
+        }
+    });
+    values[size] = block_offset[block_num];
+}
+
+// arr[0, size) = value
+template<typename T>
+void ParallelFill(size_t thread_num, T *arr, ui size, T value) {
+    auto block_num = GlueBlockNum(thread_num, size);
+    auto step = size / block_num + 1;
+    ForEachGlueBlock(thread_num, block_num, [arr, value, step, size](ui b_start, ui b_end) {
+        fill(arr + min(b_start * step, size), arr + min(b_end * step, size), value);
+    });
+}
+
+// appends the i in [0, size) with pred(i) to out, ascending: flags per block counted, scanned, then written
+template<typename T, typename F>
+void ParallelSelect(size_t thread_num, ui size, F pred, vector<T> &out) {
+    auto block_num = GlueBlockNum(thread_num, size);
+    auto step = size / block_num + 1;
+    vector<ui> block_offset(block_num + 1, 0);
+    ForEachGlueBlock(thread_num, block_num, [&pred, &block_offset, step, size](ui b_start, ui b_end) {
+        for (auto b = b_start; b < b_end; b++) {
+            auto count = 0u;
+            for (auto i = b * step; i < min(b * step + step, size); i++) { if (pred(i)) { ++count; }}
+            block_offset[b] = count;
+        }
+    });
+    ParallelExclusiveScan(thread_num, block_offset);
+    auto out_start = out.size();
+    out.resize(out_start + block_offset[block_num]);
+    ForEachGlueBlock(thread_num, block_num, [&pred, &block_offset, &out, out_start, step, size](ui b_start,
+                                                                                                  ui b_end) {
+        for (auto b = b_start; b < b_end; b++) {
+            auto pos = out_start + block_offset[b];
+            for (auto i = b * step; i < min(b * step + step, size); i++) {
+                if (pred(i)) { out[pos++] = static_cast<T>(i); }
+            }
+        }
+    });
+}
+
+// appends the parts to out in their order, each part copied by one task at its scanned offset
+template<typename T>
+void ParallelConcat(size_t thread_num, const vector<vector<T>> &parts, vector<T> &out) {
+    auto part_num = static_cast<ui>(parts.size());
+    vector<size_t> part_offset(part_num + 1, 0);
+    for (ui p = 0; p < part_num; p++) { part_offset[p] = parts[p].size(); }
+    ParallelExclusiveScan(thread_num, part_offset);
+    auto out_start = out.size();
+    out.resize(out_start + part_offset[part_num]);
+    auto copy_parts = [&parts, &part_offset, &out, out_start](ui p_start, ui p_end) {
+        for (auto p = p_start; p < p_end; p++) {
+            copy(parts[p].begin(), parts[p].end(), out.begin() + out_start + part_offset[p]);
+        }
+    };
+    if (GlueBlockNum(thread_num, part_offset[part_num]) == 1) {
+        copy_parts(0u, part_num);
+    } else {
+        ParallelForStatic(thread_num, part_num, copy_parts);
+    }
+}
+
+#endif //PPSCAN_PARALLEL_RUNTIME_H
@@ -187,7 +187,7 @@ int Graph::IntersectNeighborSetsAVX2(int u, int v, int min_cn_num) {
 
 #if defined(ENABLE_AVX2_MERGE)
 int Graph::IntersectNeighborSetsAVX2MergePopCnt(int u, int v, int min_cn_num) {
-    if (degree[u] > degree[v]) {
+    if (Degree(u) > Degree(v)) {
         auto tmp = u;
         u = v;
         v = tmp;
@@ -464,7 +464,7 @@ int Graph::IntersectNeighborSetsAVX512NoDuDv(int u, int v, int min_cn_num) {
 
 #if defined(ENABLE_AVX512_MERGE)
 int Graph::IntersectNeighborSetsAVX512MergePopCnt(int u, int v, int min_cn_num) {
-    if (degree[u] > degree[v]) {
+    if (Degree(u) > Degree(v)) {
         auto tmp = u;
         u = v;
         v = tmp;
@@ -599,20 +599,71 @@ int Graph::IntersectNeighborSets(int u, int v, int min_cn_num) {
 }
 
 int Graph::EvalSimilarity(int u, ui edge_idx) {
-    int v = out_edges[edge_idx];
+    return EvalSimilarity(u, edge_idx, min_cn[edge_idx]);
+}
+
+bool Graph::IsSignaturePruned(int u, int v, int min_cn_num) {
+    // the closed-neighborhood bound counts u and v themselves, as the kernels do
+    if (signatures_ptr != nullptr && min(Degree(u), Degree(v)) <= SIGNATURE_COUNT_MAX &&
+        signatures_ptr->UpperBound(u, v) < min_cn_num) {
+        __sync_fetch_and_add(&signature_pruned, 1);
+        return true;
+    }
+    return false;
+}
+
+int Graph::EvalSimilarity(int u, ui edge_idx, int min_cn_num) {
+    if (!edge_weights.empty()) { return EvalWeightedSimilarity(u, edge_idx); }
+    auto v = out_edges[edge_idx];
+    if (IsSignaturePruned(u, v, min_cn_num)) { return NOT_SIMILAR; }
+    if (min_hash_ptr != nullptr) {
+        auto decision = MinHashDecide(u, v, min_cn_num);
+        if (decision != 0) { return decision; }
+    }
+    return IntersectSelectedKernel(u, v, min_cn_num);
+}
+
+int Graph::IntersectSelectedKernel(int u, int v, int min_cn_num) {
+#if defined(ENABLE_KERNEL_DISPATCH)
+    switch (profile.kernel) {
 #if defined(ENABLE_AVX512)
-    return IntersectNeighborSetsAVX512(u, v, min_cn[edge_idx]);
+        case IntersectKernel::AVX512:
+            return IntersectNeighborSetsAVX512(u, v, min_cn_num);
+#endif
+#if defined(ENABLE_AVX512_NO_DU_DV)
+        case IntersectKernel::AVX512_NO_DU_DV:
+            return IntersectNeighborSetsAVX512NoDuDv(u, v, min_cn_num);
+#endif
+#if defined(ENABLE_AVX512_MERGE)
+        case IntersectKernel::AVX512_MERGE:
+            return IntersectNeighborSetsAVX512MergePopCnt(u, v, min_cn_num);
+#endif
+#if defined(ENABLE_AVX2)
+        case IntersectKernel::AVX2:
+            return IntersectNeighborSetsAVX2(u, v, min_cn_num);
+#endif
+#if defined(ENABLE_AVX2_MERGE)
+        case IntersectKernel::AVX2_MERGE:
+            return IntersectNeighborSetsAVX2MergePopCnt(u, v, min_cn_num);
+#endif
+        case IntersectKernel::SSE:
+            return IntersectNeighborSetsSSE(u, v, min_cn_num);
+        default:
+            return IntersectNeighborSets(u, v, min_cn_num);
+    }
+#elif defined(ENABLE_AVX512)
+    return IntersectNeighborSetsAVX512(u, v, min_cn_num);
 #elif defined(ENABLE_AVX512_NO_DU_DV)
-    return IntersectNeighborSetsAVX512NoDuDv(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSetsAVX512NoDuDv(u, v, min_cn_num);
 #elif defined(ENABLE_AVX512_MERGE)
-    return IntersectNeighborSetsAVX512MergePopCnt(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSetsAVX512MergePopCnt(u, v, min_cn_num);
 #elif defined(ENABLE_AVX2)
-    return IntersectNeighborSetsAVX2(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSetsAVX2(u, v, min_cn_num);
 #elif defined(ENABLE_AVX2_MERGE)
-    return IntersectNeighborSetsAVX2MergePopCnt(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSetsAVX2MergePopCnt(u, v, min_cn_num);
 #elif defined(ENABLE_SSE)
-    return IntersectNeighborSetsSSE(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSetsSSE(u, v, min_cn_num);
 #else
-    return IntersectNeighborSets(u, v, min_cn[edge_idx]);
+    return IntersectNeighborSets(u, v, min_cn_num);
 #endif
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef PPSCAN_SIMILARITY_POLICY_H
+#define PPSCAN_SIMILARITY_POLICY_H
+
+#include <cmath>
+
+/*
+ * structural similarity measures as compile-time policies, one per binary (SIMILARITY_JACCARD selects jaccard):
+ * on closed neighborhoods each reduces to cn >= MinCn(du, dv), so the intersection kernels, their early
+ * termination (cn reaching min_cn, or the remaining elements unable to) and the min_cn states are shared; a policy
+ * gives the degree prune test and the threshold, in integer math on eps = eps_a / eps_b
+ */
+class CosinePolicy {
+    long long eps_a2, eps_b2;
+
+public:
+    static constexpr const char *NAME = "cosine";
+
+    explicit CosinePolicy(int eps_a = 1, int eps_b = 1) : eps_a2(static_cast<long long>(eps_a) * eps_a),
+                                                            eps_b2(static_cast<long long>(eps_b) * eps_b) {}
+
+    // deg_a <= deg_b, cn <= deg_a: not similar when deg_a^2 < eps^2 * deg_a * deg_b
+    bool IsDegreePruned(int deg_a, int deg_b) const {
+        return static_cast<long long>(deg_a) * eps_b2 < static_cast<long long>(deg_b) * eps_a2;
+    }
+
+    // cn / sqrt(du * dv) >= eps: the smallest c with c^2 >= eps^2 * du * dv
+    int MinCn(int du, int dv) const {
+        auto c = (int) (sqrtl((((long double) du) * ((long double) dv) * eps_a2) / eps_b2));
+        if (((long long) c) * ((long long) c) * eps_b2 < ((long long) du) * ((long long) dv) * eps_a2) { ++c; }
+        return c;
+    }
+
+    static double Value(int cn, int du, int dv) {
+        return cn / sqrt(static_cast<double>(du) * dv);
+    }
+};
+
+class JaccardPolicy {
+    long long eps_a, eps_b;
+
+public:
+    static constexpr const char *NAME = "jaccard";
+
+    explicit JaccardPolicy(int eps_a = 1, int eps_b = 1) : eps_a(eps_a), eps_b(eps_b) {}
+
+    // deg_a <= deg_b, cn <= deg_a: not similar when deg_a < eps * deg_b
+    bool IsDegreePruned(int deg_a, int deg_b) const {
+        return static_cast<long long>(deg_a) * eps_b < static_cast<long long>(deg_b) * eps_a;
+    }
+
+    // cn / (du + dv - cn) >= eps: cn >= eps * (du + dv) / (1 + eps), rounded up
+    int MinCn(int du, int dv) const {
+        auto numerator = eps_a * (static_cast<long long>(du) + dv), denominator = eps_a + eps_b;
+        return static_cast<int>((numerator + denominator - 1) / denominator);
+    }
+
+    static double Value(int cn, int du, int dv) {
+        return static_cast<double>(cn) / (du + dv - cn);
+    }
+};
+
+#if defined(SIMILARITY_JACCARD)
+using Similarity = JaccardPolicy;
+#else
+using Similarity = CosinePolicy;
+#endif
+
+#endif //PPSCAN_SIMILARITY_POLICY_H
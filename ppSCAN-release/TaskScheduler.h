@@ -0,0 +1,107 @@
+#ifndef PPSCAN_TASK_SCHEDULER_H
+#define PPSCAN_TASK_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "ParallelRuntime.h"
+
+using ui=unsigned int;
+using namespace std;
+
+// parallelism and task granularity of every phase, tunable per machine and graph
+struct ScheduleConfig {
+    size_t thread_num = std::thread::hardware_concurrency();
+    // aim at tasks_per_thread tasks per worker, but never cut below min_task_cost
+    long tasks_per_thread = 32;
+    long min_task_cost = 32 * 1024;
+    // print per-phase busy time: always in USE_LOG builds, otherwise with the busy-report option
+#ifdef USE_LOG
+    bool is_report = true;
+#else
+    bool is_report = false;
+#endif
+};
+
+// cut [i_start, i_end) into contiguous ranges appended to tasks, each with estimated cost around task_cost
+// items with zero cost (no work at all) never open a new range
+inline void PartitionByCost(const long *cost, ui i_start, ui i_end, long task_cost, vector<RangeTask> &tasks) {
+    auto beg = i_start;
+    long acc = 0;
+    for (auto i = i_start; i < i_end; i++) {
+        if (acc == 0 && cost[i] == 0) {
+            beg = i + 1;
+            continue;
+        }
+        acc += cost[i];
+        if (acc >= task_cost) {
+            tasks.push_back({beg, i + 1, acc});
+            beg = i + 1;
+            acc = 0;
+        }
+    }
+    if (acc > 0) { tasks.push_back({beg, i_end, acc}); }
+}
+
+// per-phase load balance: max/mean of per-worker busy time, 1.0 is perfectly balanced
+// runtime overhead: wall time of the dispatch not covered by the busiest worker
+inline void ReportBusyTime(const char *phase_name, const vector<RangeTask> &tasks, const vector<double> &busy_time,
+                           double wall_time) {
+    auto max_busy = busy_time.empty() ? 0.0 : *max_element(busy_time.begin(), busy_time.end());
+    auto mean_busy = busy_time.empty() ? 0.0 :
+                     accumulate(busy_time.begin(), busy_time.end(), 0.0) / busy_time.size();
+    cout << phase_name << ": tasks:" << tasks.size() << ", max task cost:"
+         << (tasks.empty() ? 0 : tasks.front().cost) << ", busy max/mean:" << max_busy * 1000 << "/"
+         << mean_busy * 1000 << " ms, imbalance:" << (mean_busy > 0 ? max_busy / mean_busy : 1.0)
+         << ", " << RuntimeName() << " wall/overhead:" << wall_time * 1000 << "/"
+         << max(0.0, wall_time - max_busy) * 1000 << " ms\n";
+}
+
+/*
+ * ExecuteLongestFirst: cost-model task partitioning plus longest-processing-time-first dispatching
+ * cost_func(i): estimated work of item i, 0 means item i is a no-op and can be skipped
+ * task_func(beg, end): processes the items in [beg, end)
+ */
+template<typename CostF, typename TaskF>
+void ExecuteLongestFirst(const char *phase_name, const ScheduleConfig &config, ui size, CostF cost_func,
+                         TaskF task_func) {
+    using namespace std::chrono;
+    auto thread_num = config.thread_num;
+    // 1st: estimate item costs, statically split since estimation is cheap and uniform, every entry written there
+    unique_ptr<long[]> cost(new long[size]);
+    auto total_cost = ParallelReduce(thread_num, size, 0l, [&cost, &cost_func](ui i_start, ui i_end) {
+        auto local_cost = 0l;
+        for (auto i = i_start; i < i_end; i++) {
+            cost[i] = cost_func(i);
+            local_cost += cost[i];
+        }
+        return local_cost;
+    });
+
+    // 2nd: balanced contiguous chunks, cut per glue block and stitched in order, the heaviest dispatched first
+    auto task_cost = max(config.min_task_cost, total_cost / static_cast<long>(thread_num * config.tasks_per_thread));
+    auto block_num = GlueBlockNum(thread_num, size);
+    auto step = size / block_num + 1;
+    vector<vector<RangeTask>> block_tasks(block_num);
+    ForEachGlueBlock(thread_num, block_num, [&cost, &block_tasks, task_cost, step, size](ui b_start, ui b_end) {
+        for (auto b = b_start; b < b_end; b++) {
+            PartitionByCost(cost.get(), min(b * step, size), min(b * step + step, size), task_cost, block_tasks[b]);
+        }
+    });
+    vector<RangeTask> tasks;
+    ParallelConcat(thread_num, block_tasks, tasks);
+    stable_sort(tasks.begin(), tasks.end(), [](const RangeTask &l, const RangeTask &r) { return l.cost > r.cost; });
+
+    vector<double> busy_time;
+    auto dispatch_start = high_resolution_clock::now();
+    ParallelForTasks(thread_num, tasks, task_func, busy_time);
+    auto wall_time = duration<double>(high_resolution_clock::now() - dispatch_start).count();
+    if (config.is_report) { ReportBusyTime(phase_name, tasks, busy_time, wall_time); }
+}
+
+#endif //PPSCAN_TASK_SCHEDULER_H
@@ -10,11 +10,13 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <chrono>
 
 // https://github.com/progschj/ThreadPool
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t threads);
+    // busy_time: optional, per-worker accumulated task execution time (seconds), filled when joined
+    explicit ThreadPool(size_t threads, std::vector<double> *busy_time = nullptr);
 
     template<class F, class... Args>
     auto enqueue(F &&f, Args &&... args)
@@ -35,11 +37,12 @@ private:
 };
 
 // the constructor just launches some amount of workers
-ThreadPool::ThreadPool(size_t threads) : stop(false) {
+inline ThreadPool::ThreadPool(size_t threads, std::vector<double> *busy_time) : stop(false) {
+    if (busy_time != nullptr) { busy_time->assign(threads, 0.0); }
     workers.reserve(threads);
     for (size_t i = 0; i < threads; ++i)
         workers.emplace_back(
-                [this] {
+                [this, i, busy_time] {
                     for (;;) {
                         std::function<void()> task;
                         {
@@ -51,7 +54,14 @@ ThreadPool::ThreadPool(size_t threads) : stop(false) {
                             task = std::move(this->tasks.front());
                             this->tasks.pop();
                         }
-                        task();
+                        if (busy_time == nullptr) {
+                            task();
+                        } else {
+                            auto task_start = std::chrono::high_resolution_clock::now();
+                            task();
+                            (*busy_time)[i] += std::chrono::duration<double>(
+                                    std::chrono::high_resolution_clock::now() - task_start).count();
+                        }
                     }
                 }
         );
@@ -80,7 +90,7 @@ auto ThreadPool::enqueue(F &&f, Args &&... args) -> std::future<typename std::re
 }
 
 // the destructor joins all threads
-ThreadPool::~ThreadPool() {
+inline ThreadPool::~ThreadPool() {
     {
         std::unique_lock<std::mutex> lock(queue_mutex);
         stop = true;
@@ -7,6 +7,7 @@
 
 #include <atomic>
 #include <iostream>
+#include <memory>
 
 /**
      * source: https://github.com/wjakob/dset
@@ -114,4 +115,59 @@ public:
     mutable std::atomic<uint64_t> *mData;
 };
 
+/**
+ * Lock-free disjoint sets with 4 bytes per element: the larger root is linked under the smaller one by CAS,
+ * path halving in FindRoot, so the root of a set is always its minimum element
+ */
+class CompactDisjointSets {
+public:
+    explicit CompactDisjointSets(uint32_t size) : data_size(size), mParent(new std::atomic<uint32_t>[size]) {
+        for (uint32_t i = 0; i < size; ++i)
+            mParent[i] = i;
+    }
+
+    uint32_t FindRoot(uint32_t id) const {
+        for (;;) {
+            uint32_t parent = mParent[id].load(std::memory_order_relaxed);
+            if (parent == id)
+                return id;
+            uint32_t grand_parent = mParent[parent].load(std::memory_order_relaxed);
+            /* Try to halve the path (may fail, that's ok) */
+            if (parent != grand_parent)
+                mParent[id].compare_exchange_weak(parent, grand_parent);
+            id = grand_parent;
+        }
+    }
+
+    bool IsSameSet(uint32_t id1, uint32_t id2) const {
+        for (;;) {
+            id1 = FindRoot(id1);
+            id2 = FindRoot(id2);
+            if (id1 == id2)
+                return true;
+            if (mParent[id1].load() == id1)
+                return false;
+        }
+    }
+
+    uint32_t Union(uint32_t id1, uint32_t id2) {
+        for (;;) {
+            id1 = FindRoot(id1);
+            id2 = FindRoot(id2);
+            if (id1 == id2)
+                return id1;
+            if (id1 < id2)
+                std::swap(id1, id2);
+            uint32_t expected = id1;
+            if (mParent[id1].compare_exchange_strong(expected, id2))
+                return id2;
+        }
+    }
+
+    uint32_t size() const { return data_size; }
+
+    uint32_t data_size;
+    std::unique_ptr<std::atomic<uint32_t>[]> mParent;   // owned, the sets are move-only
+};
+
 #endif //PPSCAN_THREADSAFE_DISJOINTSET_H
\ No newline at end of file
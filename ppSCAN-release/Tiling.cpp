@@ -0,0 +1,79 @@
+#include "Graph.h"
+
+#include "TaskScheduler.h"
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+bool Graph::IsTilePending(int u, ui edge_idx) {
+    return u < out_edges[edge_idx] && min_cn[edge_idx] > 0;
+}
+
+void Graph::TiledCheckCoreFirstBSP() {
+    auto start = high_resolution_clock::now();
+    auto thread_num = profile.schedule.thread_num;
+    EdgeTiles tiles(thread_num, n, out_edge_start, tile_cache_bytes);
+
+    // bucket the pending edges of the undecided vertices by tile pair: count, prefix sum, scatter
+    auto &bucket_start = tiles.bucket_start;
+    ParallelForStatic(thread_num, n, [this, &tiles, &bucket_start](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            if (core_status_lst[u] != UN_KNOWN) { continue; }
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (IsTilePending(u, edge_idx)) {
+                    __sync_fetch_and_add(&bucket_start[tiles.PairRank(u, out_edges[edge_idx])], 1);
+                }
+            }
+        }
+    });
+    auto pair_num = tiles.PairNum();
+    auto non_empty_num = ParallelReduce(thread_num, pair_num, 0u, [&bucket_start](ui r_start, ui r_end) {
+        auto local_num = 0u;
+        for (auto r = r_start; r < r_end; r++) { if (bucket_start[r] > 0) { ++local_num; }}
+        return local_num;
+    });
+    ParallelExclusiveScan(thread_num, bucket_start);
+    tiles.pending.resize(bucket_start[pair_num]);
+    vector<ui> bucket_cursor(bucket_start.begin(), bucket_start.end() - 1);
+    ParallelForStatic(thread_num, n, [this, &tiles, &bucket_cursor](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            if (core_status_lst[u] != UN_KNOWN) { continue; }
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                if (IsTilePending(u, edge_idx)) {
+                    auto pos = __sync_fetch_and_add(&bucket_cursor[tiles.PairRank(u, out_edges[edge_idx])], 1);
+                    tiles.pending[pos] = {static_cast<int>(u), edge_idx};
+                }
+            }
+        }
+    });
+    vector<ui>().swap(bucket_cursor);
+    auto bucket_end = high_resolution_clock::now();
+    cout << "2nd: tiles:" << tiles.tile_num << ", non-empty tile pairs:" << non_empty_num << ", pending edges:"
+         << tiles.pending.size() << ", bucketing time:" << duration_cast<milliseconds>(bucket_end - start).count()
+         << " ms\n";
+
+    // consecutive pairs share a tile, tasks are contiguous ranges of pairs
+    ExecuteLongestFirst("2nd: tiled check core first-phase bsp", profile.schedule, pair_num,
+                        [this, &tiles](ui r) -> long {
+                            long cost = 0;
+                            for (auto i = tiles.bucket_start[r]; i < tiles.bucket_start[r + 1]; i++) {
+                                auto &edge = tiles.pending[i];
+                                cost += Degree(edge.u) + Degree(out_edges[edge.edge_idx]);
+                            }
+                            return cost;
+                        }, [this, &tiles](ui r_start, ui r_end) {
+                auto mirror_writer = NewMirrorWriter();
+                for (auto i = tiles.bucket_start[r_start]; i < tiles.bucket_start[r_end]; i++) {
+                    auto &edge = tiles.pending[i];
+                    // early termination as in CheckCoreFirstBSP: u decided meanwhile
+                    if (core_status_lst[edge.u] != UN_KNOWN) {
+                        __sync_fetch_and_add(&candidates_skipped, 1);
+                        continue;
+                    }
+                    if (min_cn[edge.edge_idx] > 0) {
+                        ComputeSimilarityOnce(edge.u, edge.edge_idx, false, mirror_writer.get());
+                    }
+                }
+            });
+}
@@ -0,0 +1,67 @@
+#ifndef PPSCAN_TILING_H
+#define PPSCAN_TILING_H
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ParallelRuntime.h"
+
+using ui=unsigned int;
+using namespace std;
+
+/*
+ * tiled check-core: the adjacency array is cut at fixed offsets into tiles of half the cache budget, a vertex in the
+ * tile where its list starts (the last list of a tile may run over, the tiles are vertex-id ranges), the pending
+ * edges (u, v), u < v, are bucketed by their tile pair (tile(u), tile(v)) and the pairs processed row by row in
+ * serpentine order, so consecutive pairs share one of their two tiles
+ */
+constexpr size_t DEFAULT_TILE_CACHE_BYTES = 1024 * 1024;
+constexpr ui MAX_TILE_NUM = 1024;
+
+// L2 size of this machine, the per-worker cache budget
+inline size_t DefaultTileCacheBytes() {
+    auto l2_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return l2_bytes > 0 ? static_cast<size_t>(l2_bytes) : DEFAULT_TILE_CACHE_BYTES;
+}
+
+struct PendingEdge {
+    int u;
+    ui edge_idx;
+};
+
+class EdgeTiles {
+public:
+    ui tile_num;
+    size_t tile_bytes;
+    vector<uint16_t> tile_of;
+    vector<ui> bucket_start;    // pending edges of the pair of rank r: [bucket_start[r], bucket_start[r + 1])
+    vector<PendingEdge> pending;
+
+    EdgeTiles(size_t thread_num, ui n, const vector<ui> &out_edge_start, size_t cache_bytes) : tile_of(n) {
+        // both tiles of a pair in the budget, ceil(total / tile_bytes) <= MAX_TILE_NUM tiles
+        auto total_bytes = static_cast<size_t>(out_edge_start[n]) * sizeof(int);
+        tile_bytes = max(max(cache_bytes / 2, (total_bytes + MAX_TILE_NUM - 1) / MAX_TILE_NUM), static_cast<size_t>(1));
+        tile_num = max(static_cast<ui>((total_bytes + tile_bytes - 1) / tile_bytes), 1u);
+        ParallelForStatic(thread_num, n, [this, &out_edge_start](ui i_start, ui i_end) {
+            for (auto u = i_start; u < i_end; u++) {
+                auto tile = min(static_cast<size_t>(out_edge_start[u]) * sizeof(int) / tile_bytes, tile_num - 1ul);
+                tile_of[u] = static_cast<uint16_t>(tile);
+            }
+        });
+        bucket_start.assign(PairNum() + 1, 0);
+    }
+
+    ui PairNum() const { return tile_num * (tile_num + 1) / 2; }
+
+    // serpentine order of the pairs (i, j), i <= j: row i ascending in j for even i, descending for odd i
+    ui PairRank(int u, int v) const {
+        ui i = tile_of[u], j = tile_of[v];
+        auto row_offset = i * tile_num - i * (i - 1) / 2;
+        return row_offset + (i % 2 == 0 ? j - i : tile_num - 1 - j);
+    }
+};
+
+#endif //PPSCAN_TILING_H
@@ -10,6 +10,7 @@
 namespace yche {
     constexpr int NOT_SIMILAR = -2;
     constexpr int SIMILAR = -1;
+    constexpr int IN_PROGRESS = 0;  // claimed by a worker computing the similarity
 
     constexpr char TRUE = 1;
     constexpr char FALSE = 0;
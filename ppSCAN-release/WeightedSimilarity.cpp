@@ -0,0 +1,134 @@
+#include "Graph.h"
+
+#include <cmath>
+
+#include <immintrin.h>
+
+#include "util/log/log.h"
+
+using namespace std::chrono;
+using namespace yche;
+
+bool Graph::SetWeighted() {
+#if defined(SIMILARITY_JACCARD)
+    cout << "weighted similarity is cosine, not available in the jaccard binaries\n";
+    return false;
+#else
+    if (!io_helper_ptr->ReadWeights(edge_weights)) {
+        cout << "no b_weight.bin with " << out_edges.size() << " weights, unweighted run\n";
+        return false;
+    }
+    auto start = high_resolution_clock::now();
+    // the bounds take the largest weights as upper bounds and the states are shared by both directions
+    auto invalid_num = ParallelReduce(profile.schedule.thread_num, n, 0l, [this](ui i_start, ui i_end) {
+        auto local_num = 0l;
+        for (auto u = i_start; u < i_end; u++) {
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                auto v = out_edges[edge_idx];
+                auto reverse_edge_idx = BinarySearch(out_edges, out_edge_start[v], out_edge_start[v + 1], u);
+                if (!isfinite(edge_weights[edge_idx]) || edge_weights[edge_idx] < 0 ||
+                    edge_weights[edge_idx] != edge_weights[reverse_edge_idx]) { ++local_num; }
+            }
+        }
+        return local_num;
+    });
+    if (invalid_num > 0) {
+        cout << "b_weight.bin has " << invalid_num << " negative, non-finite or asymmetric weights, unweighted run\n";
+        vector<float>().swap(edge_weights);
+        return false;
+    }
+    weight_norms.resize(n);
+    max_weights.resize(n);
+    ParallelForStatic(profile.schedule.thread_num, n, [this](ui i_start, ui i_end) {
+        for (auto u = i_start; u < i_end; u++) {
+            auto square_sum = 1.0;
+            auto max_weight = 0.0f;
+            for (auto edge_idx = out_edge_start[u]; edge_idx < out_edge_start[u + 1]; edge_idx++) {
+                square_sum += static_cast<double>(edge_weights[edge_idx]) * edge_weights[edge_idx];
+                max_weight = max(max_weight, edge_weights[edge_idx]);
+            }
+            weight_norms[u] = sqrt(square_sum);
+            max_weights[u] = max_weight;
+        }
+    });
+    auto end = high_resolution_clock::now();
+    cout << "weighted cosine, validation and norms time:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
+    return true;
+#endif
+}
+
+int Graph::WeightedPruneState(int u, ui edge_idx) {
+    auto v = out_edges[edge_idx];
+    auto target = eps * weight_norms[u] * weight_norms[v];
+    auto sum = 2.0 * edge_weights[edge_idx];
+    if (sum >= target) { return SIMILAR; }
+    // the open lists hold each other, so at most min - 1 common neighbors
+    auto common_bound = min(Degree(u), Degree(v)) - 2;
+    if (sum + common_bound * static_cast<double>(max_weights[u]) * max_weights[v] < target) { return NOT_SIMILAR; }
+    return WEIGHTED_UNDECIDED;
+}
+
+int Graph::EvalWeightedSimilarity(int u, ui edge_idx) {
+    auto v = out_edges[edge_idx];
+    auto target = eps * weight_norms[u] * weight_norms[v];
+    auto sum = 2.0 * edge_weights[edge_idx];
+#if defined(ENABLE_AVX2)
+    return IntersectWeightedAVX2(u, v, sum, target);
+#else
+    return IntersectWeighted(u, v, out_edge_start[u], out_edge_start[v], sum, target);
+#endif
+}
+
+int Graph::IntersectWeighted(int u, int v, ui offset_u, ui offset_v, double sum, double target) {
+    auto end_u = out_edge_start[u + 1], end_v = out_edge_start[v + 1];
+    auto max_product = static_cast<double>(max_weights[u]) * max_weights[v];
+    while (offset_u < end_u && offset_v < end_v) {
+        if (sum + min(end_u - offset_u, end_v - offset_v) * max_product < target) { return NOT_SIMILAR; }
+        if (out_edges[offset_u] < out_edges[offset_v]) {
+            ++offset_u;
+        } else if (out_edges[offset_u] > out_edges[offset_v]) {
+            ++offset_v;
+        } else {
+            sum += static_cast<double>(edge_weights[offset_u]) * edge_weights[offset_v];
+            if (sum >= target) { return SIMILAR; }
+            ++offset_u;
+            ++offset_v;
+        }
+    }
+    return sum >= target ? SIMILAR : NOT_SIMILAR;
+}
+
+#if defined(ENABLE_AVX2)
+int Graph::IntersectWeightedAVX2(int u, int v, double sum, double target) {
+    constexpr ui parallelism = 8;
+    auto offset_u = out_edge_start[u], offset_v = out_edge_start[v];
+    auto end_u = out_edge_start[u + 1], end_v = out_edge_start[v + 1];
+    auto max_product = static_cast<double>(max_weights[u]) * max_weights[v];
+    // lane i takes lane i + 1
+    auto rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    while (offset_u + parallelism <= end_u && offset_v + parallelism <= end_v) {
+        if (sum + min(end_u - offset_u, end_v - offset_v) * max_product < target) { return NOT_SIMILAR; }
+        auto ids_u = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&out_edges[offset_u]));
+        auto ids_v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&out_edges[offset_v]));
+        auto weights_u = _mm256_loadu_ps(&edge_weights[offset_u]);
+        auto weights_v = _mm256_loadu_ps(&edge_weights[offset_v]);
+        auto acc = _mm256_setzero_ps();
+        for (auto r = 0u; r < parallelism; r++) {
+            auto match = _mm256_castsi256_ps(_mm256_cmpeq_epi32(ids_u, ids_v));
+            acc = _mm256_add_ps(acc, _mm256_and_ps(match, _mm256_mul_ps(weights_u, weights_v)));
+            ids_v = _mm256_permutevar8x32_epi32(ids_v, rotate);
+            weights_v = _mm256_permutevar8x32_ps(weights_v, rotate);
+        }
+        alignas(32) float partial[parallelism];
+        _mm256_store_ps(partial, acc);
+        for (auto p: partial) { sum += p; }
+        if (sum >= target) { return SIMILAR; }
+
+        // the block with the smaller last element is exhausted, both on a tie
+        auto last_u = out_edges[offset_u + parallelism - 1], last_v = out_edges[offset_v + parallelism - 1];
+        if (last_u <= last_v) { offset_u += parallelism; }
+        if (last_v <= last_u) { offset_v += parallelism; }
+    }
+    return IntersectWeighted(u, v, offset_u, offset_v, sum, target);
+}
+#endif
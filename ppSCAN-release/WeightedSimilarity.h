@@ -0,0 +1,14 @@
+#ifndef PPSCAN_WEIGHTED_SIMILARITY_H
+#define PPSCAN_WEIGHTED_SIMILARITY_H
+
+/*
+ * weighted cosine on closed neighborhoods (self weight 1): sigma(u, v) = sum_x w(u, x) * w(v, x) / (|u| * |v|),
+ * |u| = sqrt(1 + sum_x w(u, x)^2); u and v contribute 2 * w(u, v), the common neighbors at most w_max(u) * w_max(v)
+ * each, which give the prune bounds and the early termination of the kernels
+ */
+
+// min_cn of an edge left to the weighted kernels, positive as the unweighted thresholds, never below the SIMILAR
+// shortcut of those
+constexpr int WEIGHTED_UNDECIDED = 3;
+
+#endif //PPSCAN_WEIGHTED_SIMILARITY_H
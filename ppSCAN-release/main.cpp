@@ -12,7 +12,15 @@
 #include "Graph.h"
 
 void Usage() {
-    cout << "Usage: [1]exe [2]graph-dir [3]similarity-threshold [4]density-threshold [5 optional]Output\n";
+    cout << "Usage: [1]exe [2]graph-dir [3]similarity-threshold [4]density-threshold [options, any order]\n"
+            "  output: output summary hubs export-similarity\n"
+            "  run: dataflow | compact | anytime[=<budget-ms>] (default: pSCAN phases)\n"
+            "  pSCAN phases: tiled[=<cache-KB>] core-subgraph engine=<pipeline|all-edge|auto>\n"
+            "  similarity: signature[=<buckets>] minhash[=<error-rate>] agreement weighted\n"
+            "  check-core: owner-computes order=<adjacency|cheapest|likely-similar> interleave[=<width>]\n"
+            "  core clustering: cc=<wjakob|link-by-index|rem|afforest> cc-bench "
+            "(afforest scans the full lists, also with core-subgraph)\n"
+            "  tuning: tune busy-report\n";
 }
 
 int main(int argc, char *argv[]) {
@@ -26,13 +34,197 @@ int main(int argc, char *argv[]) {
         auto io_end = high_resolution_clock::now();
         cout << "\nTotal input cost:" << duration_cast<milliseconds>(io_end - io_start).count() << " ms\n";
 
+        auto is_output = false;
+        auto is_tune = false;
+        auto is_dataflow = false;
+        auto is_owner_computes = false;
+        auto is_compact = false;
+        auto signature_buckets = 0u;
+        auto candidate_order = CandidateOrder::ADJACENCY;
+        auto interleave_width = 1u;
+        size_t tile_cache_bytes = 0;
+        auto is_core_subgraph = false;
+        auto cc_engine = DEFAULT_CC_ENGINE;
+        auto is_cc_bench = false;
+        auto is_summary = false;
+        auto is_hubs = false;
+        auto anytime_budget_ms = -1.0;
+        auto min_hash_error = 0.0;
+        auto is_agreement = false;
+        auto is_weighted = false;
+        auto similarity_engine = SimilarityEngine::PIPELINE;
+        auto is_engine_given = false;
+        auto is_export_similarity = false;
+        auto is_busy_report = false;
+        for (auto i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "output") == 0) { is_output = true; }
+            if (strcmp(argv[i], "tune") == 0) { is_tune = true; }
+            if (strcmp(argv[i], "dataflow") == 0) { is_dataflow = true; }
+            if (strcmp(argv[i], "owner-computes") == 0) { is_owner_computes = true; }
+            if (strcmp(argv[i], "compact") == 0) { is_compact = true; }
+            if (strncmp(argv[i], "order=", strlen("order=")) == 0) {
+                candidate_order = ParseCandidateOrder(argv[i] + strlen("order="));
+            }
+            if (strncmp(argv[i], "interleave", strlen("interleave")) == 0) {
+                interleave_width = argv[i][strlen("interleave")] == '=' ?
+                                   static_cast<ui>(atoi(argv[i] + strlen("interleave="))) : DEFAULT_INTERLEAVE_WIDTH;
+            }
+            if (strcmp(argv[i], "core-subgraph") == 0) { is_core_subgraph = true; }
+            if (strncmp(argv[i], "cc=", strlen("cc=")) == 0) { cc_engine = ParseCCEngine(argv[i] + strlen("cc=")); }
+            if (strcmp(argv[i], "cc-bench") == 0) { is_cc_bench = true; }
+            if (strcmp(argv[i], "summary") == 0) { is_summary = true; }
+            if (strcmp(argv[i], "hubs") == 0) { is_hubs = true; }
+            if (strncmp(argv[i], "anytime", strlen("anytime")) == 0) {
+                anytime_budget_ms = argv[i][strlen("anytime")] == '=' ? atof(argv[i] + strlen("anytime=")) : 0;
+            }
+            if (strncmp(argv[i], "minhash", strlen("minhash")) == 0) {
+                min_hash_error = argv[i][strlen("minhash")] == '=' ? atof(argv[i] + strlen("minhash="))
+                                                                   : DEFAULT_MIN_HASH_ERROR;
+            }
+            if (strcmp(argv[i], "agreement") == 0) { is_agreement = true; }
+            if (strcmp(argv[i], "weighted") == 0) { is_weighted = true; }
+            if (strncmp(argv[i], "engine=", strlen("engine=")) == 0) {
+                similarity_engine = ParseSimilarityEngine(argv[i] + strlen("engine="));
+                is_engine_given = true;
+            }
+            if (strcmp(argv[i], "export-similarity") == 0) { is_export_similarity = true; }
+            if (strcmp(argv[i], "busy-report") == 0) { is_busy_report = true; }
+            if (strncmp(argv[i], "tiled", strlen("tiled")) == 0) {
+                tile_cache_bytes = argv[i][strlen("tiled")] == '=' ?
+                                   static_cast<size_t>(atol(argv[i] + strlen("tiled="))) * 1024 :
+                                   DefaultTileCacheBytes();
+            }
+            if (strncmp(argv[i], "signature", strlen("signature")) == 0) {
+                signature_buckets = argv[i][strlen("signature")] == '=' ?
+                                    static_cast<ui>(atoi(argv[i] + strlen("signature="))) : DEFAULT_SIGNATURE_BUCKETS;
+            }
+        }
+        // tiles and the core subgraph are modes of the pSCAN phases, the other runs drop them
+        const char *run_name = is_compact ? "compact" : is_dataflow ? "dataflow" :
+                                                        anytime_budget_ms >= 0 ? "anytime" : nullptr;
+        if (run_name != nullptr && tile_cache_bytes > 0) {
+            cout << run_name << " run has no tiled mode, tiled ignored\n";
+            tile_cache_bytes = 0;
+        }
+        if (run_name != nullptr && is_core_subgraph) {
+            cout << run_name << " run has no core-subgraph mode, core-subgraph ignored\n";
+            is_core_subgraph = false;
+        }
+        if (run_name != nullptr && similarity_engine != SimilarityEngine::PIPELINE) {
+            cout << run_name << " run has no similarity engine, engine=" << SimilarityEngineName(similarity_engine)
+                 << " ignored\n";
+            similarity_engine = SimilarityEngine::PIPELINE;
+        }
+        if (run_name != nullptr && is_export_similarity) {
+            cout << run_name << " run keeps no similarities, export-similarity ignored\n";
+            is_export_similarity = false;
+        }
+        // the compact layout keeps no min_cn mirror, evaluates in adjacency order and merges one edge at a time
+        if (is_compact && is_dataflow) {
+            cout << "compact run keeps the barriers, dataflow ignored\n";
+            is_dataflow = false;
+        }
+        if (is_compact && is_owner_computes) {
+            cout << "compact run has no mirror writes, owner-computes ignored\n";
+            is_owner_computes = false;
+        }
+        if (is_compact && candidate_order != CandidateOrder::ADJACENCY) {
+            cout << "compact run has no candidate order, order=" << CandidateOrderName(candidate_order)
+                 << " ignored\n";
+            candidate_order = CandidateOrder::ADJACENCY;
+        }
+        if (is_compact && interleave_width > 1) {
+            cout << "compact run has no interleaved mode, interleave ignored\n";
+            interleave_width = 1;
+        }
+        if (is_compact && cc_engine != DEFAULT_CC_ENGINE) {
+            cout << "compact run has its own link-by-index sets, cc=" << CCEngineName(cc_engine) << " ignored\n";
+            cc_engine = DEFAULT_CC_ENGINE;
+        }
+        // tune on a separate graph instance, the profile is saved and picked up by the one below
+        if (is_tune) {
+            graph->AutoTune();
+            delete graph;
+            graph = new Graph(argv[1], argv[2], atoi(argv[3]));
+        }
+
+        // weights validated first, a weighted run computes every similarity with the weights: the unweighted tests
+        // and engines do not apply
+        if (is_weighted) { is_weighted = graph->SetWeighted(); }
+        if (is_weighted && signature_buckets > 0) {
+            cout << "weighted run: the signatures bound unweighted counts, signature ignored\n";
+            signature_buckets = 0;
+        }
+        if (is_weighted && min_hash_error > 0) {
+            cout << "weighted run: the sketches estimate unweighted counts, minhash ignored\n";
+            min_hash_error = 0;
+        }
+        if (is_weighted && interleave_width > 1) {
+            cout << "weighted run: the interleaved merges count unweighted, interleave ignored\n";
+            interleave_width = 1;
+        }
+        if (is_weighted && similarity_engine != SimilarityEngine::PIPELINE) {
+            cout << "weighted run: engine=" << SimilarityEngineName(similarity_engine)
+                 << " counts unweighted triangles, engine=pipeline\n";
+            similarity_engine = SimilarityEngine::PIPELINE;
+        }
+        if (is_weighted && is_export_similarity) {
+            cout << "weighted run: the exported similarities are unweighted, export-similarity ignored\n";
+            is_export_similarity = false;
+        }
+
+        // the exported similarities are the exact counts of the all-edge engine
+        if (is_export_similarity && is_engine_given && similarity_engine == SimilarityEngine::PIPELINE) {
+            cout << "export-similarity needs engine=all-edge, engine=pipeline given, export-similarity ignored\n";
+            is_export_similarity = false;
+        } else if (is_export_similarity && similarity_engine != SimilarityEngine::ALL_EDGE) {
+            cout << "export-similarity: engine=" << SimilarityEngineName(similarity_engine) << " replaced by engine="
+                 << SimilarityEngineName(SimilarityEngine::ALL_EDGE) << "\n";
+            similarity_engine = SimilarityEngine::ALL_EDGE;
+        }
+        // the all-edge engine computes every edge exactly, auto may pick it
+        if (similarity_engine != SimilarityEngine::PIPELINE && min_hash_error > 0) {
+            if (similarity_engine == SimilarityEngine::AUTO) {
+                cout << "minhash: engine=auto could pick the exact all-edge engine, engine=pipeline\n";
+                similarity_engine = SimilarityEngine::PIPELINE;
+            } else {
+                cout << "engine=all-edge computes every edge exactly, minhash ignored\n";
+                min_hash_error = 0;
+            }
+        }
+        if (similarity_engine == SimilarityEngine::ALL_EDGE && signature_buckets > 0) {
+            cout << "engine=all-edge has no pruning tests, signature ignored\n";
+            signature_buckets = 0;
+        }
+
+        // signatures built with the graph, before the timed computation
+        if (signature_buckets > 0) { graph->SetSignatureBuckets(signature_buckets); }
+        if (min_hash_error > 0) { graph->SetMinHash(min_hash_error); }
+
         // compute
         auto start = high_resolution_clock::now();
 #ifdef WITHGPERFTOOLS
         cout << "with google perf start------------\n";
         ProfilerStart("pscanProfile.log");
 #endif
-        graph->pSCAN();
+        if (is_busy_report) { graph->SetBusyReport(true); }
+        graph->SetOwnerComputes(is_owner_computes);
+        graph->SetCandidateOrder(candidate_order);
+        graph->SetInterleaveWidth(interleave_width);
+        graph->SetTileCacheBytes(tile_cache_bytes);
+        graph->SetCoreSubgraph(is_core_subgraph);
+        graph->SetCCEngine(cc_engine);
+        graph->SetSimilarityEngine(similarity_engine);
+        graph->SetSimilarityExport(is_export_similarity);
+        if (is_compact) {
+            graph->pSCANCompact();
+        } else if (is_dataflow) {
+            graph->pSCANDataflow();
+        } else if (anytime_budget_ms >= 0) {
+            graph->pSCANAnytime(anytime_budget_ms);
+        } else {
+            graph->pSCAN();
+        }
 #ifdef WITHGPERFTOOLS
         cout << "with google perf end--------------\n";
         ProfilerStop();
@@ -40,9 +232,28 @@ int main(int argc, char *argv[]) {
         auto end = high_resolution_clock::now();
         cout << "Total time without IO:" << duration_cast<milliseconds>(end - start).count() << " ms\n";
 
+        // the compact layout has its own link-by-index sets
+        if (is_cc_bench && !is_compact) { graph->BenchmarkCCEngines(); }
+
+        // exact reference on a second instance, for the approximate modes
+        if (is_agreement) {
+            auto *exact = new Graph(argv[1], argv[2], atoi(argv[3]));
+            if (is_weighted) { exact->SetWeighted(); }
+            exact->pSCAN();
+            graph->ReportAgreement(*exact);
+            delete exact;
+        }
+
         // Output
         io_start = high_resolution_clock::now();
-        if (argc >= 5 && strcmp(argv[4], "output") == 0) { graph->Output(argv[2], argv[3]); }
+        if (is_summary || is_hubs) { graph->BuildClusterSummary(); }
+        if (is_hubs) { graph->ClassifyHubsOutliers(); }
+        if (is_output) {
+            graph->Output(argv[2], argv[3]);
+            if (is_hubs) { graph->OutputRoles(argv[2], argv[3]); }
+        }
+        if (is_summary) { graph->OutputSummary(argv[2], argv[3]); }
+        if (is_export_similarity) { graph->OutputSimilarities(argv[2], argv[3]); }
         io_end = high_resolution_clock::now();
         cout << "Total output cost:" << duration_cast<milliseconds>(io_end - io_start).count() << " ms\n\n";
     }
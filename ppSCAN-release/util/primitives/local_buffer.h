@@ -1,11 +1,18 @@
 #pragma once
 
-#include <cstring>
+#include <algorithm>
+#include <atomic>
 
-// T requires to be a trivially copyable type,
-// I is the global_buffer_size type.
+template<typename I>
+I FetchAndAdd(volatile I *counter, I value) { return __sync_fetch_and_add(counter, value); }
+
+template<typename I>
+I FetchAndAdd(std::atomic<I> *counter, I value) { return counter->fetch_add(value); }
+
+// T requires to be a copy-assignable type, trivially copyable ones are submitted as a plain memory copy,
+// I is the global_buffer_size type, C the shared counter (volatile I or std::atomic<I>).
 // LocalWriteBuffer is trivially copyable, behaving like a view of pointers and sizes
-template<typename T, typename I>
+template<typename T, typename I, typename C = volatile I>
 class LocalWriteBuffer {
     T *buffer_;     // allocated outside, can be either stack or heap memory
     I buffer_size_;   // consider the cache line, multiple of 64 bytes on CPUs.
@@ -13,18 +20,18 @@ class LocalWriteBuffer {
 
     // global data.
     T *global_data_;
-    volatile I *global_buffer_size_ptr_;
+    C *global_buffer_size_ptr_;
 
     void submit() {
-        I tempIdx = __sync_fetch_and_add(global_buffer_size_ptr_, buffer_size_);
-        memcpy(global_data_ + tempIdx, buffer_, sizeof(T) * buffer_size_);
+        I tempIdx = FetchAndAdd(global_buffer_size_ptr_, buffer_size_);
+        std::copy(buffer_, buffer_ + buffer_size_, global_data_ + tempIdx);
         buffer_size_ = 0;
     }
 
 public:
     LocalWriteBuffer() = delete;
 
-    LocalWriteBuffer(T *buffer, I buffer_cap, T *global_data, volatile I *global_buffer_size) :
+    LocalWriteBuffer(T *buffer, I buffer_cap, T *global_data, C *global_buffer_size) :
             buffer_(buffer), buffer_size_(0), buffer_cap_(buffer_cap),
             global_data_(global_data), global_buffer_size_ptr_(global_buffer_size) {}
 